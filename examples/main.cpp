@@ -82,6 +82,7 @@ int main(int argc, char* argv[]) {
     cen::ui::AssetManagerWindow assetManagerWindow = {};
     assetManagerWindow.assetManager = &engine->assetManager();
     assetManagerWindow.pipelineManager = &engine->pipelineManager();
+    assetManagerWindow.pipelineMutex = &engine->pipelineMutex();
     assetManagerWindow.name = "Asset Manager";
 
     guiWorkspace.addWindow(&settingsWindow);
@@ -220,7 +221,7 @@ int main(int argc, char* argv[]) {
 
         engine->device()->beginFrame();
         engine->gc();
-        auto sceneInfo = scene.prepare();
+        auto sceneInfo = scene.prepare(renderer.renderSettings());
 
         statisticsWindow.dt = dt;
         statisticsWindow.milliseconds = milliseconds;
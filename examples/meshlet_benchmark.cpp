@@ -0,0 +1,104 @@
+
+#include <Canta/SDLWindow.h>
+#include <Canta/RenderGraph.h>
+#include <Cen/Engine.h>
+#include <Cen/Renderer.h>
+#include <Cen/Camera.h>
+#include <Cen/Scene.h>
+
+#include <map>
+
+// renders the model at every supported meshlet size and prints the average time of each render graph group. the
+// meshlet size is fixed for an engine's lifetime so each size gets its own engine, with the model rebuilt for it.
+int main(int argc, char* argv[]) {
+
+    std::filesystem::path gltfPath = {};
+    if (argc > 1)
+        gltfPath = argv[1];
+    else
+        return -1;
+
+    const u32 warmupFrames = 100;
+    const u32 frameCount = 500;
+
+    canta::SDLWindow window("Cen Meshlet Benchmark", 1920, 1080);
+
+    for (auto meshletSize : cen::MESHLET_SIZES) {
+        auto engine = cen::Engine::create({
+            .applicationName = "CenMeshletBenchmark",
+            .window = &window,
+            .assetPath = std::filesystem::path(CEN_SRC_DIR) / "res",
+            .meshShadingEnabled = true,
+            .threadCount = 4,
+            .meshletSize = meshletSize
+        });
+        {
+            auto swapchain = engine->device()->createSwapchain({
+                .window = &window
+            });
+            auto renderer = cen::Renderer::create({
+                .engine = engine.get(),
+                .swapchainFormat = swapchain->format()
+            });
+            renderer.renderGraph().setTimingEnabled(true);
+            auto scene = cen::Scene::create({
+                .engine = engine.get()
+            });
+
+            auto camera = cen::Camera::create({
+                .position = { 0, 0, 2 },
+                .rotation = ende::math::Quaternion({ 0, 0, 1 }, ende::math::rad(180)),
+                .width = 1920,
+                .height = 1080
+            });
+            camera.updateFrustum();
+            scene.addCamera("primary_camera", camera, cen::Transform::create({
+                .position = { 0, 0, 2 },
+                .rotation = ende::math::Quaternion({ 0, 0, 1 }, ende::math::rad(180))
+            }));
+            scene.addLight("light", cen::Light::create({
+                .intensity = 20,
+                .radius = 100,
+            }), cen::Transform::create({}));
+
+            auto material = engine->assetManager().loadMaterial("materials/pbr/pbr.mat");
+            auto model = engine->assetManager().loadModel(gltfPath, material);
+            auto rootNode = scene.addNode("mesh_root");
+            for (auto& mesh : model->meshes) {
+                scene.addMesh(std::format("Mesh: {}", mesh.meshletOffset), mesh, cen::Transform::create({
+                    .position = { 0, -2, 0 }
+                }), rootNode);
+            }
+
+            engine->uploadBuffer().flushStagedData();
+            engine->uploadBuffer().wait();
+            engine->uploadBuffer().clearSubmitted();
+            engine->assetManager().uploadMaterials();
+
+            std::map<std::string, f64> groupTimes = {};
+            f64 frameTime = 0;
+            for (u32 frame = 0; frame < warmupFrames + frameCount; frame++) {
+                SDL_Event event;
+                while (SDL_PollEvent(&event)) {}
+
+                engine->device()->beginFrame();
+                engine->gc();
+                auto sceneInfo = scene.prepare(renderer.renderSettings());
+                renderer.render(sceneInfo, &swapchain.value(), nullptr);
+                f64 milliseconds = engine->device()->endFrame();
+
+                if (frame < warmupFrames)
+                    continue;
+                frameTime += milliseconds;
+                for (auto& timer : renderer.renderGraph().timers())
+                    groupTimes[timer.first] += timer.second.result().value() / 1e6;
+            }
+            engine->device()->waitIdle();
+
+            std::printf("meshlet size %d/%d: %.3fms frame\n", meshletSize.vertices, meshletSize.primitives, frameTime / frameCount);
+            for (auto& [name, time] : groupTimes)
+                std::printf("    %s: %.3fms\n", name.c_str(), time / frameCount);
+        }
+    }
+    return 0;
+}
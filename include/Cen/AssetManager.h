@@ -45,9 +45,31 @@ namespace cen {
     class AssetManager {
     public:
 
+        enum class MeshletBuilder {
+            // meshopt's greedy builder, grows meshlets along triangle adjacency
+            GREEDY,
+            // k-d splits the triangles by centroid until each node fits a meshlet, for compact bounds
+            SPATIAL
+        };
+
+        // optimisation stages run on each primitive at import before its meshlets are built
+        struct ImportSettings {
+            bool weldVertices = true;
+            bool optimiseVertexCache = true;
+            bool optimiseOverdraw = true;
+            bool optimiseVertexFetch = true;
+            bool optimiseMeshlets = true;
+            MeshletBuilder meshletBuilder = MeshletBuilder::GREEDY;
+            // reads back the base colour texture of alpha tested materials so fully opaque meshlets skip the alpha test
+            bool classifyAlpha = true;
+            // fills in Model::statistics, overdraw analysis rasterises every primitive so it can be turned off
+            bool analyse = true;
+        };
+
         struct CreateInfo {
             Engine* engine = nullptr;
             std::filesystem::path rootPath = {};
+            ImportSettings importSettings = {};
         };
         static auto create(CreateInfo info) -> AssetManager;
 
@@ -63,6 +85,9 @@ namespace cen {
 
         void uploadMaterials();
 
+        // read when a model starts loading, changes apply to models loaded afterwards
+        auto importSettings() -> ImportSettings& { return _importSettings; }
+
         auto images() const -> std::span<const canta::ImageHandle> { return _images; }
         auto models() const -> std::span<const Model> { return _models; }
         auto materials() const -> std::span<const Material> { return _materials; }
@@ -85,6 +110,7 @@ namespace cen {
         std::unique_ptr<std::mutex> _assetMutex = {};
 
         std::filesystem::path _rootPath = {};
+        ImportSettings _importSettings = {};
         std::vector<std::filesystem::path> _searchPaths = {};
 
         tsl::robin_map<u32, i32> _assetMap = {};
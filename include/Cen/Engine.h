@@ -5,13 +5,27 @@
 #include <Canta/PipelineManager.h>
 #include <Canta/UploadBuffer.h>
 #include <Cen/AssetManager.h>
+#include <Cen/GeometryStreamer.h>
+#include <Cen/ShaderCache.h>
 #include <Ende/thread/ThreadPool.h>
 #include <cen.glsl>
 
 namespace cen {
 
-    constexpr const u32 MAX_MESHLET_VERTICES = 64;
-    constexpr const u32 MAX_MESHLET_PRIMTIVES = 64;
+    // meshlet dimensions are chosen at engine creation, every model is split into meshlets of this size and the mesh
+    // and primitive culling pipelines are compiled for it
+    struct MeshletSize {
+        u32 vertices = 64;
+        u32 primitives = 64;
+
+        auto operator==(const MeshletSize&) const -> bool = default;
+    };
+    // meshopt needs primitive counts that are multiples of 4 and mesh shaders are limited to 256 vertices and primitives
+    constexpr const MeshletSize MESHLET_SIZES[] = {
+        { 64, 64 },
+        { 64, 124 },
+        { 128, 256 }
+    };
 
     class Engine {
     public:
@@ -22,6 +36,15 @@ namespace cen {
             std::filesystem::path assetPath = {};
             bool meshShadingEnabled = true;
             u32 threadCount = 1;
+            // bytes of streamed geometry kept resident, 0 keeps every model fully resident
+            u64 geometryBudget = 0;
+            // must be one of MESHLET_SIZES
+            MeshletSize meshletSize = {};
+            // keeps compiled spir-v on disk so later runs skip shader compilation, see ShaderCache. off by default as
+            // cached shaders aren't hot reloaded
+            bool shaderCacheEnabled = false;
+            // defaults to shader_cache in the asset path
+            std::filesystem::path shaderCachePath = {};
         };
         static auto create(CreateInfo info) -> std::unique_ptr<Engine>;
 
@@ -34,8 +57,16 @@ namespace cen {
         auto threadPool() -> ende::thread::ThreadPool& { return *_threadPool; }
 
         auto assetManager() -> AssetManager& { return _assetManager; }
+        auto geometryStreamer() -> GeometryStreamer& { return _geometryStreamer; }
 
         auto pipelineManager() -> canta::PipelineManager& { return _pipelineManager; }
+        // pipelines are created from the thread pool and canta's pipeline manager isn't known to be thread safe, so
+        // every use of it holds this lock
+        auto pipelineMutex() -> std::mutex& { return _pipelineMutex; }
+        // builds the create info, including any shaders it requests, before taking the lock. with the shader cache
+        // enabled the pipeline is created on the device directly without the lock
+        auto getPipeline(const canta::Pipeline::CreateInfo& info) -> canta::PipelineHandle;
+        auto shaderCache() -> ShaderCache& { return _shaderCache; }
         auto uploadBuffer() -> canta::UploadBuffer& { return _uploadBuffer; }
 
         auto vertexBuffer() const -> canta::BufferHandle { return _vertexBuffer; }
@@ -43,6 +74,8 @@ namespace cen {
         auto primitiveBuffer() const -> canta::BufferHandle { return _primitiveBuffer; }
         auto meshletBuffer() const -> canta::BufferHandle { return _meshletBuffer; }
 
+        auto meshletSize() const -> MeshletSize { return _meshletSize; }
+
         auto meshShadingEnabled() const -> bool { return _meshShadingEnabled; }
         auto setMeshShadingEnabled(bool enabled) -> bool;
 
@@ -50,6 +83,9 @@ namespace cen {
         auto uploadIndexData(std::span<const u32> data) -> u32;
         auto uploadPrimitiveData(std::span<const u8> data) -> u32;
         auto uploadMeshletData(std::span<const Meshlet> data) -> u32;
+        // writes a streamed page into its slot of the geometry buffers. holds the same lock as the functions above so
+        // a buffer can't be swapped for a grown copy between the page being staged and written
+        void uploadPageData(std::span<const Vertex> vertices, u32 vertexOffset, std::span<const u32> indices, u32 indexOffset, std::span<const u8> primitives, u32 primitiveOffset, std::span<const Meshlet> meshlets, u32 meshletOffset);
 
         auto saveImageToDisk(canta::ImageHandle image, const std::filesystem::path& path, canta::ImageLayout srcLayout, bool tonemap = true) -> bool;
 
@@ -58,8 +94,10 @@ namespace cen {
         std::unique_ptr<canta::Device> _device = {};
         std::unique_ptr<ende::thread::ThreadPool> _threadPool = {};
         canta::PipelineManager _pipelineManager = {};
+        ShaderCache _shaderCache = {};
         canta::UploadBuffer _uploadBuffer = {};
         AssetManager _assetManager = {};
+        GeometryStreamer _geometryStreamer = {};
 
         canta::BufferHandle _vertexBuffer = {};
         u32 _vertexOffset = 0;
@@ -71,8 +109,10 @@ namespace cen {
         u32 _meshletOffset = 0;
 
         bool _meshShadingEnabled = true;
+        MeshletSize _meshletSize = {};
 
         std::mutex _mutex = {};
+        std::mutex _pipelineMutex = {};
 
     };
 
@@ -0,0 +1,139 @@
+#ifndef CEN_GEOMETRYSTREAMER_H
+#define CEN_GEOMETRYSTREAMER_H
+
+#include <Ende/platform.h>
+#include <Canta/Device.h>
+#include <cen.glsl>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace cen {
+
+    class Engine;
+
+    // meshlets are streamed in pages of up to this many. every page slot in the pool is sized for a full page of
+    // meshlets at the engine's meshlet size
+    constexpr const u32 MESHLET_PAGE_MESHLETS = 32;
+
+    class GeometryStreamer {
+    public:
+
+        struct CreateInfo {
+            Engine* engine = nullptr;
+            // bytes of vertex, index and primitive data the pool of page slots may use, 0 keeps all geometry resident
+            u64 budget = 0;
+            std::filesystem::path pagePath = {};
+        };
+        static auto create(CreateInfo info) -> GeometryStreamer;
+
+        GeometryStreamer() = default;
+
+        auto enabled() const -> bool { return _slotCount > 0; }
+        auto slotCount() const -> u32 { return _slotCount; }
+        auto residentPages() const -> u32;
+        auto pageCount() const -> u32 { return _pages.size(); }
+
+        // elements each page slot takes at the start of the engine vertex, index and primitive buffers, sized for the
+        // engine's meshlet size
+        auto slotVertexCount() const -> u32;
+        auto slotIndexCount() const -> u32;
+        auto slotPrimitiveCount() const -> u32;
+        auto slotCountForBudget(u64 budget) const -> u32;
+
+        // a model's streamed pages as split by the asset manager. page data holds each page's meshlets followed by its
+        // vertices, indices and primitives, with meshlet offsets relative to the page. page and group ids and meshlet
+        // indices are relative to the model until added.
+        struct Page {
+            u32 dataOffset = 0;
+            u32 firstMeshlet = 0;
+            u32 meshletCount = 0;
+            u32 vertexCount = 0;
+            u32 indexCount = 0;
+            u32 primitiveCount = 0;
+        };
+        struct Group {
+            u32 outputPage = MESHLET_PAGE_NONE;
+            std::vector<u32> memberPages = {};
+        };
+        struct PageSet {
+            std::vector<Page> pages = {};
+            std::vector<Group> groups = {};
+            std::vector<u8> data = {};
+        };
+
+        // reserves global page and group ids so the model's meshlets can reference them before they are uploaded
+        auto reserve(u32 pageCount, u32 groupCount) -> std::pair<u32, u32>;
+        void addPages(const PageSet& pageSet, u32 firstPage, u32 firstGroup, u32 meshletOffset);
+
+        // reads the requests and slot usage of the frame that last used flyingIndex, installs finished pages, starts
+        // loading newly requested ones and writes this frame's residency snapshot
+        void update(u32 flyingIndex);
+
+        auto pageBufferAddress(u32 flyingIndex) const -> u64;
+        auto groupBufferAddress(u32 flyingIndex) const -> u64;
+        auto feedbackBufferAddress(u32 flyingIndex) const -> u64;
+
+    private:
+
+        struct PageState {
+            u64 fileOffset = 0;
+            u32 firstMeshlet = 0;
+            u32 meshletCount = 0;
+            u32 vertexCount = 0;
+            u32 indexCount = 0;
+            u32 primitiveCount = 0;
+            bool loading = false;
+            u64 evictedFrame = 0;
+            std::vector<u32> groups = {};
+        };
+
+        auto loadPage(PageState page, u32 slot) -> bool;
+        void updateGroups(u32 pageIndex);
+        auto evictLeastRecentlyUsed() -> bool;
+
+        Engine* _engine = nullptr;
+        std::unique_ptr<std::mutex> _mutex = {};
+
+        std::filesystem::path _pagePath = {};
+        std::ofstream _pageFile = {};
+        u64 _pageFileSize = 0;
+
+        std::vector<PageState> _pages = {};
+        std::vector<Group> _groups = {};
+
+        // mirrored into the per frame residency buffers
+        std::vector<u32> _pageSlots = {};
+        std::vector<u32> _groupFlags = {};
+
+        struct Slot {
+            u32 page = MESHLET_PAGE_NONE;
+            u64 lastUsed = 0;
+        };
+        u32 _slotCount = 0;
+        std::vector<Slot> _slots = {};
+        std::vector<u32> _freeSlots = {};
+        // evicted slots can be reused once no frame in flight can still read them
+        std::vector<std::pair<u32, u64>> _retiredSlots = {};
+
+        struct Load {
+            u32 page = 0;
+            u32 slot = 0;
+            std::future<bool> result = {};
+        };
+        std::vector<Load> _loads = {};
+
+        u64 _frame = 0;
+
+        // page slots followed by group flags
+        canta::BufferHandle _residencyBuffers[canta::FRAMES_IN_FLIGHT] = {};
+        u32 _groupBufferOffsets[canta::FRAMES_IN_FLIGHT] = {};
+        canta::BufferHandle _feedbackBuffers[canta::FRAMES_IN_FLIGHT] = {};
+
+    };
+
+}
+
+#endif //CEN_GEOMETRYSTREAMER_H
@@ -25,6 +25,9 @@ namespace cen {
         void setTransparent(bool transparent) { _transparent = transparent; }
         auto isTransparent() const -> bool { return _transparent; }
 
+        void setDoubleSided(bool doubleSided) { _doubleSided = doubleSided; }
+        auto isDoubleSided() const -> bool { return _doubleSided; }
+
         auto setParameter(std::string_view name, std::span<const u8> data) -> bool;
 
         template<typename T>
@@ -53,6 +56,7 @@ namespace cen {
         Material* _material = nullptr;
         u32 _offset = 0;
         bool _transparent = false;
+        bool _doubleSided = false;
 
     };
 
@@ -13,10 +13,12 @@ namespace cen {
     struct Mesh {
         u32 meshletOffset = 0;
         u32 meshletCount = 0;
+        u32 primitiveCount = 0;
         ende::math::Vec4f min;
         ende::math::Vec4f max;
         MaterialInstance* materialInstance = nullptr;
         i32 alphaMapIndex = -1;
+        bool doubleSided = false;
     };
 
     class Model {
@@ -29,6 +31,22 @@ namespace cen {
             std::string name = {};
         };
 
+        // geometry quality of the imported primitives at full detail. ratios are averaged weighted by triangle count
+        // and left at zero when the model was imported without analysis
+        struct Statistics {
+            u32 vertexCount = 0;
+            u32 triangleCount = 0;
+            u32 meshletCount = 0;
+            f32 acmr = 0;
+            f32 atvr = 0;
+            f32 overdraw = 0;
+            f32 overfetch = 0;
+            f32 vertexFill = 0;
+            f32 primitiveFill = 0;
+            // bounding sphere radius in model units, smaller spheres cull more tightly
+            f32 meshletRadius = 0;
+        };
+
 //    private:
 
         std::string name = {};
@@ -37,6 +55,7 @@ namespace cen {
         //TODO: add material support
         std::vector<MaterialInstance> materials = {};
         std::vector<canta::ImageHandle> images = {};
+        Statistics statistics = {};
 
     };
 
@@ -4,12 +4,23 @@
 #include <Canta/Device.h>
 #include <Canta/RenderGraph.h>
 #include <filesystem>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <unordered_map>
 #include <cen.glsl>
 
 namespace cen {
 
     class Engine;
 
+    constexpr const u32 CLUSTER_GRID_X = 16;
+    constexpr const u32 CLUSTER_GRID_Y = 9;
+    constexpr const u32 CLUSTER_GRID_Z = 24;
+    constexpr const u32 CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+    constexpr const u32 SHADOW_MAP_RESOLUTION = 2048;
+
     namespace ui {
         class GuiWorkspace;
     }
@@ -17,14 +28,20 @@ namespace cen {
     struct SceneInfo {
         canta::BufferHandle meshBuffer = {};
         canta::BufferHandle transformBuffer = {};
+        canta::BufferHandle normalMatrixBuffer = {};
         canta::BufferHandle cameraBuffer = {};
+        canta::BufferHandle cullingViewBuffer = {};
         canta::BufferHandle lightBuffer = {};
         u32 meshCount = 0;
+        u32 meshletCount = 0;
+        u32 primitiveCount = 0;
         u32 cameraCount = 0;
         u32 primaryCamera = 0;
         u32 cullingCamera = 0;
         u32 lightCount = 0;
         i32 sunIndex = 0;
+        i32 shadowCameraIndex = -1;
+        u32 shadowCascadeCount = 0;
     };
 
     class Renderer {
@@ -37,11 +54,19 @@ namespace cen {
 
         static auto create(CreateInfo info) -> Renderer;
 
+        Renderer() = default;
+        // waits for any pipelines still being created on the thread pool
+        ~Renderer();
+
+        Renderer(Renderer&& rhs) noexcept = default;
+        auto operator=(Renderer&& rhs) noexcept -> Renderer& = default;
 
         auto render(const SceneInfo& sceneInfo, canta::Swapchain* swapchain, ui::GuiWorkspace* guiWorkspace) -> canta::ImageHandle;
 
         auto renderGraph() -> canta::RenderGraph& { return _renderGraph; }
         auto feedbackInfo() -> FeedbackInfo { return _feedbackInfo; }
+        // time taken to create the startup pipelines, compares cold and warm shader cache starts
+        auto pipelineCreateMilliseconds() const -> f64 { return _pipelineCreateMilliseconds; }
 
         struct RenderSettings {
             bool bloom = true;
@@ -49,6 +74,31 @@ namespace cen {
             f32 bloomStrength = 0.3;
             i32 tonemapModeIndex = 0;
 
+            f32 exposure = 1.0;
+            bool autoExposure = true;
+            f32 minLogLuminance = -10;
+            f32 maxLogLuminance = 2;
+            f32 exposureAdaptationRate = 1.1;
+            f32 exposureKeyValue = 0.18;
+
+            bool shadows = true;
+            i32 shadowCascadeCount = 4;
+            f32 shadowCascadeSplitLambda = 0.9;
+            f32 shadowDistance = 100;
+            f32 shadowBias = 0.0005;
+            f32 shadowNormalOffset = 1.5;
+
+            // upload per mesh normal matrices with the transforms instead of inverting them per pixel
+            bool normalMatrices = true;
+
+            // meshlets that project smaller than the threshold in pixels are rasterised in compute
+            bool softwareRaster = false;
+            f32 softwareRasterThreshold = 8;
+
+            // picks the cluster lod cut with at most this many pixels of error, disabled draws the source meshlets
+            bool clusterLod = true;
+            f32 lodErrorThreshold = 1;
+
             bool debugMeshletId = false;
             bool debugPrimitiveId = false;
             bool debugMeshId = false;
@@ -69,6 +119,13 @@ namespace cen {
 
     private:
 
+        // pipelines only some frames use are compiled on the thread pool the first time they are requested. an empty
+        // handle is returned until the pipeline is ready and the pass using it is skipped, so enabling a debug view
+        // never stalls a frame. pipeline names are kept as views so must be string literals.
+        auto asyncPipeline(const std::string& key, std::function<canta::PipelineHandle()> create) -> canta::PipelineHandle;
+        auto asyncComputePipeline(const std::filesystem::path& path, std::string_view name) -> canta::PipelineHandle;
+        auto debugFrustumPipeline() -> canta::PipelineHandle;
+
         Engine* _engine = nullptr;
         canta::RenderGraph _renderGraph = {};
 
@@ -83,24 +140,45 @@ namespace cen {
 
         canta::BufferHandle _globalBuffers[canta::FRAMES_IN_FLIGHT] = {};
         canta::BufferHandle _feedbackBuffers[canta::FRAMES_IN_FLIGHT] = {};
+        canta::BufferHandle _exposureBuffer = {};
+        canta::BufferHandle _clusterBuffers[canta::FRAMES_IN_FLIGHT] = {};
+        canta::BufferHandle _clusterLightIndexBuffers[canta::FRAMES_IN_FLIGHT] = {};
+
+        std::chrono::high_resolution_clock::time_point _lastFrameTime = {};
 
         canta::PipelineHandle _cullMeshesPipeline = {};
-        canta::PipelineHandle _writeMeshletCullCommandPipeline = {};
+        canta::PipelineHandle _expandMeshesPipeline = {};
+        canta::PipelineHandle _expandMeshesMultiViewPipeline = {};
         canta::PipelineHandle _cullMeshletsPipeline = {};
-        canta::PipelineHandle _writeMeshletDrawCommandPipeline = {};
+        canta::PipelineHandle _cullMeshesMultiViewPipeline = {};
+        canta::PipelineHandle _cullMeshletsMultiViewPipeline = {};
         canta::PipelineHandle _writePrimitivesPipeline = {};
         canta::PipelineHandle _drawMeshletsPipelineMeshPath = {};
         canta::PipelineHandle _drawMeshletsPipelineMeshAlphaPath = {};
         canta::PipelineHandle _drawMeshletsPipelineVertexPath = {};
+        canta::PipelineHandle _softwareRasterisePipeline = {};
+        canta::PipelineHandle _softwareResolvePipeline = {};
+
+        canta::PipelineHandle _drawShadowPipelineMeshPath = {};
+        canta::PipelineHandle _drawShadowPipelineMeshAlphaPath = {};
+        canta::PipelineHandle _writeShadowPrimitivesPipeline = {};
+        canta::PipelineHandle _drawShadowPipelineVertexPath = {};
+
+        canta::PipelineHandle _cullLightsPipeline = {};
 
         canta::PipelineHandle _tonemapPipeline = {};
 
         canta::PipelineHandle _bloomDownsamplePipeline = {};
         canta::PipelineHandle _bloomUpsamplePipeline = {};
-        canta::PipelineHandle _bloomCompositePipeline = {};
+
+        canta::PipelineHandle _exposureHistogramPipeline = {};
+        canta::PipelineHandle _exposureAveragePipeline = {};
 
         canta::PipelineHandle _skyPipeline = {};
 
+        std::unordered_map<std::string, std::shared_future<canta::PipelineHandle>> _asyncPipelines = {};
+        f64 _pipelineCreateMilliseconds = 0;
+
     };
 
 }
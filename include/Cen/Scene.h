@@ -25,13 +25,22 @@ namespace cen {
 //        Scene(Scene&& rhs) noexcept;
 //        auto operator=(Scene&& rhs) noexcept -> Scene&;
 
-        auto prepare() -> SceneInfo;
+        auto prepare(const Renderer::RenderSettings& settings) -> SceneInfo;
 
         auto meshCount() const -> u32 { return _meshCount; }
+        auto staticMeshCount() const -> u32 { return _staticMeshCount; }
         auto maxMeshlets() const -> u32 { return _maxMeshlets; }
         auto totalMeshlets() const -> u32 { return _totalMeshlets; }
         auto totalPrimtives() const -> u32 { return _totalPrimitives; }
 
+        // static meshes are kept in a contiguous range at the start of the mesh buffer followed by the dynamic
+        // meshes. the static range is only re-uploaded when a static mesh is added, moved or edited. mesh indices
+        // can change in prepare when meshes are repartitioned.
+        enum class Mobility {
+            STATIC = MESH_MOBILITY_STATIC,
+            DYNAMIC = MESH_MOBILITY_DYNAMIC,
+        };
+
         enum class NodeType {
             NONE = 0,
             MESH = 1,
@@ -53,10 +62,12 @@ namespace cen {
 
         auto addNode(std::string_view name, const Transform& transform = Transform(), SceneNode* parent = nullptr) -> SceneNode*;
 
-        auto addModel(std::string_view name, const Model& model, const Transform& transform, SceneNode* parent = nullptr) -> SceneNode*;
+        auto addModel(std::string_view name, const Model& model, const Transform& transform, SceneNode* parent = nullptr, Mobility mobility = Mobility::STATIC) -> SceneNode*;
 
-        auto addMesh(std::string_view name, const Mesh& mesh, const Transform& transform, SceneNode* parent = nullptr) -> SceneNode*;
+        auto addMesh(std::string_view name, const Mesh& mesh, const Transform& transform, SceneNode* parent = nullptr, Mobility mobility = Mobility::STATIC) -> SceneNode*;
         auto getMesh(SceneNode* node) -> GPUMesh&;
+        auto getMobility(SceneNode* node) const -> Mobility;
+        void setMobility(SceneNode* node, Mobility mobility);
 
         auto addCamera(std::string_view name, const Camera& camera, const Transform& transform, SceneNode* parent = nullptr) -> SceneNode*;
         auto getCamera(SceneNode* node) -> Camera&;
@@ -71,13 +82,17 @@ namespace cen {
 
 //    private:
 
+        void partitionMeshes();
+
         Engine* _engine = nullptr;
 
         std::unique_ptr<SceneNode> _rootNode = nullptr;
 
         std::vector<GPUMesh> _meshes = {};
-        std::vector<ende::math::Mat4f> _worldTransforms = {};
+        std::vector<AffineTransform> _worldTransforms = {};
+        std::vector<mat3> _normalMatrices = {};
         std::vector<GPUCamera> _gpuCameras = {};
+        std::vector<CullingView> _cullingViews = {};
         std::vector<GPULight> _gpuLights = {};
 
         std::vector<Camera> _cameras = {};
@@ -88,10 +103,17 @@ namespace cen {
 
         canta::BufferHandle _meshBuffer[canta::FRAMES_IN_FLIGHT] = {};
         canta::BufferHandle _transformBuffer[canta::FRAMES_IN_FLIGHT] = {};
+        canta::BufferHandle _normalMatrixBuffer[canta::FRAMES_IN_FLIGHT] = {};
         canta::BufferHandle _cameraBuffer[canta::FRAMES_IN_FLIGHT] = {};
+        canta::BufferHandle _cullingViewBuffer[canta::FRAMES_IN_FLIGHT] = {};
         canta::BufferHandle _lightBuffer[canta::FRAMES_IN_FLIGHT] = {};
 
         u32 _meshCount = 0;
+        u32 _staticMeshCount = 0;
+        bool _staticDirty[canta::FRAMES_IN_FLIGHT] = {};
+        // a static mesh was added after a dynamic one or a mesh changed mobility
+        bool _partitionDirty = false;
+        bool _normalMatricesEnabled = false;
         u32 _maxMeshlets = 0;
         u32 _totalMeshlets = 0;
         u32 _totalPrimitives = 0;
@@ -0,0 +1,71 @@
+#ifndef CEN_SHADERCACHE_H
+#define CEN_SHADERCACHE_H
+
+#include <Ende/platform.h>
+#include <Canta/PipelineManager.h>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cen {
+
+    class Engine;
+
+    // compiled spir-v kept on disk between runs. shaders are keyed by a hash of their source, every file they include
+    // and their macros and stage, so editing any of them misses the cache and recompiles. shaders created from the
+    // cache are not hot reloaded, disable it while editing shaders. only shaders requested through here are cached,
+    // material pipelines are built by the pipeline manager from their pipeline files and always compile from source.
+    // shaders can be requested from several threads at once. with the cache enabled hashing, compiling to spir-v and
+    // cache file reads and writes run in parallel and only registering the module with the pipeline manager takes the
+    // engine's pipeline lock. with it disabled the pipeline manager compiles the shader under the lock so it can be
+    // reloaded. concurrent requests for the same shader wait on the first one.
+    class ShaderCache {
+    public:
+
+        struct CreateInfo {
+            Engine* engine = nullptr;
+            std::filesystem::path rootPath = {};
+            // directory the spir-v is written to, empty disables the cache and shaders are compiled from source
+            std::filesystem::path cachePath = {};
+            // searched for includes not found next to the shader or in rootPath, matched by file name
+            std::vector<std::filesystem::path> includePaths = {};
+        };
+        static auto create(CreateInfo info) -> ShaderCache;
+
+        ShaderCache() = default;
+
+        struct ShaderInfo {
+            std::filesystem::path path = {};
+            std::vector<canta::Macro> macros = {};
+            canta::ShaderStage stage = {};
+        };
+        auto getShader(const ShaderInfo& info) -> canta::ShaderHandle;
+
+        auto enabled() const -> bool { return !_cachePath.empty(); }
+        auto hits() const -> u32 { return _hits; }
+        auto misses() const -> u32 { return _misses; }
+
+    private:
+
+        auto key(const ShaderInfo& info) const -> u64;
+        auto read(u64 key) const -> std::vector<u32>;
+        void write(u64 key, std::span<const u32> spirv) const;
+
+        Engine* _engine = nullptr;
+        std::unique_ptr<std::mutex> _mutex = {};
+        std::filesystem::path _rootPath = {};
+        std::filesystem::path _cachePath = {};
+        std::unordered_map<std::string, std::filesystem::path> _includes = {};
+
+        std::unordered_map<std::string, std::shared_future<canta::ShaderHandle>> _shaders = {};
+
+        u32 _hits = 0;
+        u32 _misses = 0;
+
+    };
+
+}
+
+#endif //CEN_SHADERCACHE_H
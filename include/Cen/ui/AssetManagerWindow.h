@@ -2,6 +2,7 @@
 #define CEN_ASSETMANAGERWINDOW_H
 
 #include <Cen/ui/Window.h>
+#include <mutex>
 
 namespace canta {
     class PipelineManager;
@@ -20,6 +21,8 @@ namespace cen::ui {
 
         AssetManager* assetManager = nullptr;
         canta::PipelineManager* pipelineManager = nullptr;
+        // held while the pipeline manager is used, see Engine::pipelineMutex
+        std::mutex* pipelineMutex = nullptr;
     };
 
 }
@@ -9,7 +9,9 @@ vec4 evalMaterial(Material material, InterpolatedValues values, GlobalData globa
 
     vec3 result = ambient;
 
-    for (uint lightIndex = 0; lightIndex < globalData.maxLightCount; lightIndex++) {
+    LightCluster cluster = globalData.clusterBufferRef.clusters[values.clusterIndex];
+    for (uint i = 0; i < cluster.count; i++) {
+        uint lightIndex = globalData.clusterLightIndexBufferRef.indices[cluster.offset + i];
         GPULight light = globalData.lightBufferRef[lightIndex].light;
 
         vec3 lightVec = vec3(0.0);
@@ -17,6 +19,7 @@ vec4 evalMaterial(Material material, InterpolatedValues values, GlobalData globa
         float attenuation = 1.0;
         if (light.type == 0) {
             lightDir = normalize(light.position);
+            attenuation = directionalShadow(globalData, light, values.worldPosition, values.normal);
         } else {
             lightVec = light.position - values.worldPosition;
             lightDir = normalize(lightVec);
@@ -80,10 +80,13 @@ vec4 evalMaterial(Material material, InterpolatedValues values, GlobalData globa
 
     vec3 colour = vec3(0.0);
 
-    for (uint lightIndex = 0; lightIndex < globalData.maxLightCount; lightIndex++) {
+    LightCluster cluster = globalData.clusterBufferRef.clusters[values.clusterIndex];
+    for (uint i = 0; i < cluster.count; i++) {
+        uint lightIndex = globalData.clusterLightIndexBufferRef.indices[cluster.offset + i];
         GPULight light = globalData.lightBufferRef[lightIndex].light;
 
-        colour += evalLight(material, values, light, camera);
+        float shadow = light.type == 0 ? directionalShadow(globalData, light, values.worldPosition, values.normal) : 1.0;
+        colour += evalLight(material, values, light, camera) * shadow;
     }
 
     vec3 emissive = material.albedo.rgb * material.emissive * material.emissiveStrength;
@@ -35,6 +35,9 @@ declareBufferReference(DispatchIndirectCommandBuffer,
     DispatchIndirectCommand command;
 );
 
+#define MESH_MOBILITY_STATIC 0
+#define MESH_MOBILITY_DYNAMIC 1
+
 struct GPUMesh {
     uint meshletOffset;
     uint meshletCount;
@@ -43,7 +46,12 @@ struct GPUMesh {
     int materialId;
     uint materialOffset;
     int alphaMapIndex;
+    uint mobility;
+    vec4 boundingSphere; // local space, xyz center w radius
+    uint flags;
 };
+// set from the glTF material, back facing triangles of the mesh are kept
+#define MESH_FLAG_DOUBLE_SIDED 1u
 declareBufferReference(MeshBuffer,
     GPUMesh meshes[];
 );
@@ -56,7 +64,30 @@ struct Meshlet {
     uint primitiveCount;
     vec3 center;
     float radius;
+    vec3 coneAxis;
+    float coneCutoff; // 1 when the meshlet can't be cone culled
+    // cluster dag lod. lod bounds and error belong to the group this meshlet was simplified from (zero error for
+    // source meshlets), parent bounds and error to the group simplified from this meshlet (MESHLET_ROOT_ERROR at
+    // the root). both are in the mesh's local space.
+    vec3 lodCenter;
+    float lodRadius;
+    float lodError;
+    vec3 parentCenter;
+    float parentRadius;
+    float parentError;
+    // geometry streaming. the page holding this meshlet's geometry and the dag groups it was simplified from and into,
+    // MESHLET_PAGE_NONE and MESHLET_GROUP_NONE when always resident or outside the dag
+    uint page;
+    uint lodGroup;
+    uint parentGroup;
+    uint flags;
 };
+#define MESHLET_ROOT_ERROR 3.402823466e+38
+// set at import on meshlets of alpha tested meshes whose uv footprint only covers texels passing the alpha test, they
+// are drawn by the opaque pass without it
+#define MESHLET_FLAG_OPAQUE 1u
+// alpha below this is discarded by the alpha test
+#define ALPHA_TEST_THRESHOLD 0.8
 declareBufferReference(MeshletBuffer,
     Meshlet meshlets[];
 );
@@ -71,6 +102,27 @@ declareBufferReference(MeshletInstanceBuffer,
     MeshletInstance instances[];
 );
 
+// a visible mesh and the first instance its meshlets expand to, written by mesh culling and
+// expanded one meshlet per thread by expand_meshes.comp
+struct MeshRange {
+    uint meshId;
+    uint instanceOffset;
+    uint viewMask;
+};
+
+// views are a contiguous range of culling views, bit n of the mask is set if the instance passed view n
+#define MAX_CULLING_VIEWS 32
+struct MultiViewMeshletInstance {
+    uint meshletId;
+    uint meshId;
+    uint viewMask;
+};
+declareBufferReference(MultiViewMeshletInstanceBuffer,
+    uint opaqueCount;
+    uint alphaCount;
+    MultiViewMeshletInstance instances[];
+);
+
 struct Vertex {
     vec3 position;
     vec3 normal;
@@ -89,8 +141,31 @@ declareBufferReference(MeshletIndexBuffer,
     uint indexCount;
     uint indices[];
 );
+// the last row of an affine transform is always (0, 0, 0, 1) so only the first three rows are stored
+struct AffineTransform {
+    vec4 rows[3];
+};
 declareBufferReference(TransformsBuffer,
-    mat4 transforms[];
+    AffineTransform transforms[];
+);
+
+#ifndef __cplusplus
+vec3 transformPoint(AffineTransform transform, vec3 point) {
+    vec4 p = vec4(point, 1.0);
+    return vec3(dot(transform.rows[0], p), dot(transform.rows[1], p), dot(transform.rows[2], p));
+}
+
+vec3 transformDirection(AffineTransform transform, vec3 direction) {
+    return vec3(dot(transform.rows[0].xyz, direction), dot(transform.rows[1].xyz, direction), dot(transform.rows[2].xyz, direction));
+}
+
+mat4 expandTransform(AffineTransform transform) {
+    return transpose(mat4(transform.rows[0], transform.rows[1], transform.rows[2], vec4(0, 0, 0, 1)));
+}
+#endif
+// inverse transpose of the upper 3x3 of each transform up to scale, indexed the same as TransformsBuffer
+declareBufferReference(NormalMatrixBuffer,
+    mat3 normalMatrices[];
 );
 
 struct Frustum {
@@ -100,6 +175,8 @@ struct Frustum {
 struct GPUCamera {
     mat4 projection;
     mat4 view;
+    mat4 viewProjection;
+    mat4 inverseViewProjection;
     vec3 position;
     float near;
     float far;
@@ -109,6 +186,16 @@ declareBufferReference(CameraBuffer,
     GPUCamera camera;
 );
 
+// the subset of a camera the culling passes need, kept separate so they don't pull the full GPUCamera per thread
+struct CullingView {
+    vec4 planes[6];
+    mat4 view;
+    vec4 projection; // projection[0][0], projection[1][1], near, far
+};
+declareBufferReference(CullingViewBuffer,
+    CullingView views[];
+);
+
 struct GPULight {
     vec3 position;
     uint type;
@@ -135,6 +222,52 @@ declareBufferReference(FeedbackInfoRef,
     FeedbackInfo info;
 );
 
+// geometry streaming. pages of meshlets are streamed into a fixed pool of page slots, each frame sees a snapshot of
+// the slot every page is resident in and the residency of every dag group
+#define MESHLET_PAGE_NONE 0xFFFFFFFFu
+#define MESHLET_GROUP_NONE 0xFFFFFFFFu
+#define MESHLET_GROUP_OUTPUTS_RESIDENT 1u
+#define MESHLET_GROUP_MEMBERS_RESIDENT 2u
+#define MAX_PAGE_REQUESTS 1024
+declareBufferReference(MeshletPageBuffer,
+    uint slots[]; // MESHLET_PAGE_NONE when not resident
+);
+declareBufferReference(MeshletGroupBuffer,
+    uint flags[];
+);
+declareBufferReference(PageFeedbackBuffer,
+    uint requests[MAX_PAGE_REQUESTS]; // hashed set of requested pages, MESHLET_PAGE_NONE for empty entries
+    uint slotUsage[]; // non zero for slots drawn from this frame
+);
+
+#define MAX_SHADOW_CASCADES 4
+
+// lights past this many in one cluster are dropped from it, the first ones in light buffer order are kept
+#define MAX_LIGHTS_PER_CLUSTER 128
+struct LightCluster {
+    uint offset;
+    uint count;
+};
+declareBufferReference(LightClusterBuffer,
+    LightCluster clusters[];
+);
+declareBufferReference(ClusterLightIndexBuffer,
+    uint indices[];
+);
+
+#define EXPOSURE_HISTOGRAM_BINS 256
+declareBufferReference(HistogramBuffer,
+    uint bins[];
+);
+
+struct ExposureData {
+    float exposure;
+    float averageLuminance;
+};
+declareBufferReference(ExposureBuffer,
+    ExposureData data;
+);
+
 struct GlobalData {
     uint maxMeshCount;
     uint maxMeshletCount;
@@ -147,21 +280,38 @@ struct GlobalData {
     int primaryCamera;
     int textureSampler;
     int depthSampler;
+    int shadowMapIndex;
+    uint shadowCascadeCount;
+    float shadowBias;
+    float shadowNormalOffset;
+    float lodErrorThreshold; // pixels of simplification error allowed by the cluster lod cut, 0 draws source meshlets
+    uvec4 clusterGrid;
     MeshBuffer meshBufferRef;
     MeshletBuffer meshletBufferRef;
     VertexBuffer vertexBufferRef;
     IndexBuffer indexBufferRef;
     PrimitiveBuffer primitiveBufferRef;
     TransformsBuffer transformsBufferRef;
+    NormalMatrixBuffer normalMatrixBufferRef;
     CameraBuffer cameraBufferRef;
+    CullingViewBuffer cullingViewBufferRef;
     LightBuffer lightBufferRef;
     FeedbackInfoRef feedbackInfoRef;
+    ExposureBuffer exposureBufferRef;
+    LightClusterBuffer clusterBufferRef;
+    ClusterLightIndexBuffer clusterLightIndexBufferRef;
+    // null when geometry streaming is disabled
+    MeshletPageBuffer meshletPageBufferRef;
+    MeshletGroupBuffer meshletGroupBufferRef;
+    PageFeedbackBuffer pageFeedbackBufferRef;
 };
 declareBufferReference(GlobalDataRef,
     GlobalData globalData;
 );
 
-#define MAX_MESHLET_INSTANCE 10000000
-#define MESHLET_CLEAR_ID MAX_MESHLET_INSTANCE + 1
+// meshlet instance capacity is sized from the scene at runtime (GlobalData::maxMeshletCount). the visibility buffer
+// packs the instance index into 24 bits so that is the hard upper bound, with the all ones value left as the clear id.
+#define MESHLET_INSTANCE_LIMIT ((1u << 24) - 1u)
+#define MESHLET_CLEAR_ID 0xFFFFFFFFu
 
 #endif
\ No newline at end of file
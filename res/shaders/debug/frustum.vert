@@ -38,5 +38,5 @@ void main() {
 
     vertexOut.colour = colour;
 
-    gl_Position = camera.projection * camera.view * fragPos;
+    gl_Position = camera.viewProjection * fragPos;
 }
\ No newline at end of file
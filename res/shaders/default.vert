@@ -13,11 +13,13 @@ layout (push_constant) uniform Push {
     GlobalDataRef globalDataRef;
     MeshletInstanceBuffer meshletInstanceBuffer;
     MeshletIndexBuffer meshletIndexBuffer;
+    int cameraIndex;
+    int padding;
 };
 
 void main() {
 
-    GPUCamera camera = globalDataRef.globalData.cameraBufferRef[globalDataRef.globalData.primaryCamera].camera;
+    GPUCamera camera = globalDataRef.globalData.cameraBufferRef[cameraIndex].camera;
 
     uint meshletIndex = meshletIndexBuffer.indices[gl_VertexIndex];
     uint meshletId = getMeshletId(meshletIndex);
@@ -27,9 +29,9 @@ void main() {
     uint index = globalDataRef.globalData.indexBufferRef.indices[meshlet.indexOffset + primitive];
     Vertex vertex = globalDataRef.globalData.vertexBufferRef.vertices[index];
 
-    vec4 fragPos = globalDataRef.globalData.transformsBufferRef.transforms[instance.meshId] * vec4(vertex.position, 1);
+    vec4 fragPos = vec4(transformPoint(globalDataRef.globalData.transformsBufferRef.transforms[instance.meshId], vertex.position), 1);
 
-    gl_Position = camera.projection * camera.view * fragPos;
+    gl_Position = camera.viewProjection * fragPos;
     vertexOut.drawId = instance.meshId;
     vertexOut.meshletId = meshletId;
     vertexOut.uv = vertex.uv;
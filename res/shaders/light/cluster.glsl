@@ -0,0 +1,21 @@
+#ifndef LIGHT_CLUSTER_GLSL
+#define LIGHT_CLUSTER_GLSL
+
+// clusters are sliced exponentially in view space depth between the camera near and far planes
+uint clusterSlice(float viewDepth, GPUCamera camera, uint sliceCount) {
+    float logRatio = log(camera.far / camera.near);
+    float slice = log(max(viewDepth, camera.near)) * (float(sliceCount) / logRatio) - float(sliceCount) * log(camera.near) / logRatio;
+    return uint(clamp(slice, 0.0, float(sliceCount - 1)));
+}
+
+float clusterSliceDepth(uint slice, GPUCamera camera, uint sliceCount) {
+    return camera.near * pow(camera.far / camera.near, float(slice) / float(sliceCount));
+}
+
+uint clusterIndex(vec2 screenUV, float viewDepth, GPUCamera camera, uvec4 clusterGrid) {
+    uvec2 tile = min(uvec2(screenUV * vec2(clusterGrid.xy)), clusterGrid.xy - 1);
+    uint slice = clusterSlice(viewDepth, camera, clusterGrid.z);
+    return tile.x + tile.y * clusterGrid.x + slice * clusterGrid.x * clusterGrid.y;
+}
+
+#endif //LIGHT_CLUSTER_GLSL
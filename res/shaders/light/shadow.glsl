@@ -0,0 +1,43 @@
+#ifndef LIGHT_SHADOW_GLSL
+#define LIGHT_SHADOW_GLSL
+
+// cascades are laid out left to right in a single atlas with the same camera order they were fitted in.
+// expects sampledImages and samplers to be declared by the including shader.
+float sampleCascade(GlobalData globalData, uint cascade, vec3 shadowCoords, ivec2 cascadeSize) {
+    ivec2 tileMin = ivec2(int(cascade) * cascadeSize.x, 0);
+    ivec2 tileMax = tileMin + cascadeSize - 1;
+    ivec2 texel = tileMin + ivec2(shadowCoords.xy * vec2(cascadeSize));
+
+    float lit = 0.0;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 coords = clamp(texel + ivec2(x, y), tileMin, tileMax);
+            float depth = texelFetch(sampler2D(sampledImages[globalData.shadowMapIndex], samplers[globalData.depthSampler]), coords, 0).r;
+            // reverse z so occluders closer to the light have a larger depth
+            lit += shadowCoords.z + globalData.shadowBias >= depth ? 1.0 : 0.0;
+        }
+    }
+    return lit / 9.0;
+}
+
+float directionalShadow(GlobalData globalData, GPULight light, vec3 worldPosition, vec3 normal) {
+    if (light.cameraIndex < 0 || globalData.shadowMapIndex < 0)
+        return 1.0;
+
+    ivec2 atlasSize = textureSize(sampler2D(sampledImages[globalData.shadowMapIndex], samplers[globalData.depthSampler]), 0);
+    ivec2 cascadeSize = ivec2(atlasSize.x / int(globalData.shadowCascadeCount), atlasSize.y);
+
+    for (uint cascade = 0; cascade < globalData.shadowCascadeCount; cascade++) {
+        GPUCamera camera = globalData.cameraBufferRef[light.cameraIndex + cascade].camera;
+        // offset along the normal by a few cascade texels to avoid acne on surfaces facing away from the light
+        float texelSize = 2.0 / (camera.projection[0][0] * float(cascadeSize.x));
+        vec4 clip = camera.viewProjection * vec4(worldPosition + normal * texelSize * globalData.shadowNormalOffset, 1.0);
+        vec3 ndc = clip.xyz / clip.w;
+        if (any(greaterThan(abs(ndc.xy), vec2(1.0))) || ndc.z < 0.0 || ndc.z > 1.0)
+            continue;
+        return sampleCascade(globalData, cascade, vec3(ndc.xy * 0.5 + 0.5, ndc.z), cascadeSize);
+    }
+    return 1.0;
+}
+
+#endif //LIGHT_SHADOW_GLSL
@@ -0,0 +1,53 @@
+#ifndef MESH_RANGE_GLSL
+#define MESH_RANGE_GLSL
+
+// requires GL_EXT_shader_explicit_arithmetic_types_int64 and GL_EXT_shader_atomic_int64.
+// the counters pack the instance count in the high 32 bits and the range count in the low 32 bits so one atomic
+// reserves both, which keeps ranges sorted by instanceOffset. alpha ranges are stored backwards from rangeCapacity.
+// the finished counters are the last workgroup counters of mesh culling and the opaque and alpha meshlet culling dispatches.
+declareBufferReference(MeshRangeBuffer,
+    uint64_t opaqueCounter;
+    uint64_t alphaCounter;
+    uint meshesFinished;
+    uint opaqueMeshletsFinished;
+    uint alphaMeshletsFinished;
+    uint padding;
+    MeshRange ranges[];
+);
+
+uint rangeCount(uint64_t counter) {
+    return uint(counter & 0xffffffffUL);
+}
+
+uint instanceCount(uint64_t counter) {
+    return uint(counter >> 32);
+}
+
+// only available when util/subgroup.glsl is included first.
+// reserves a range slot and meshletCount instances for each active invocation with append set using one 64 bit atomic
+// per subgroup. ranges stay sorted by instance offset since both are assigned in lane order.
+// returns (rangeIndex, instanceOffset)
+#ifdef SUBGROUP_GLSL
+uvec2 subgroupReserveRanges(MeshRangeBuffer meshRangeBuffer, bool alpha, bool append, uint meshletCount) {
+    uint count = append ? meshletCount : 0;
+    uvec4 ballot = subgroupBallot(append);
+    uint rangeTotal = subgroupBallotBitCount(ballot);
+    uint instanceTotal = subgroupAdd(count);
+    uint instanceOffset = subgroupExclusiveAdd(count);
+
+    uvec2 base = uvec2(0);
+    if (subgroupElect() && rangeTotal > 0) {
+        uint64_t reservation = (uint64_t(instanceTotal) << 32) | uint64_t(rangeTotal);
+        uint64_t reserved;
+        if (alpha)
+            reserved = atomicAdd(meshRangeBuffer.alphaCounter, reservation);
+        else
+            reserved = atomicAdd(meshRangeBuffer.opaqueCounter, reservation);
+        base = uvec2(rangeCount(reserved), instanceCount(reserved));
+    }
+    base = subgroupBroadcastFirst(base);
+    return base + uvec2(subgroupBallotExclusiveBitCount(ballot), instanceOffset);
+}
+#endif
+
+#endif //MESH_RANGE_GLSL
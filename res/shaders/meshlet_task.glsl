@@ -0,0 +1,14 @@
+#ifndef MESHLET_TASK_GLSL
+#define MESHLET_TASK_GLSL
+
+#ifndef TASK_WORKGROUP_SIZE
+#define TASK_WORKGROUP_SIZE 64
+#endif
+
+// indices into the meshlet instance buffer of the meshlets that survived task shader culling,
+// one mesh workgroup is launched per entry
+struct TaskPayload {
+    uint meshletIndices[TASK_WORKGROUP_SIZE];
+};
+
+#endif //MESHLET_TASK_GLSL
@@ -0,0 +1,122 @@
+#ifndef CULLING_GLSL
+#define CULLING_GLSL
+
+// bounds are stored in local space so the tests take the instance transform. expects cen.glsl to be included first.
+
+// largest axis scale of the transform, a local space radius times this bounds the transformed sphere
+float maxScale(AffineTransform transform) {
+    vec3 x = vec3(transform.rows[0].x, transform.rows[1].x, transform.rows[2].x);
+    vec3 y = vec3(transform.rows[0].y, transform.rows[1].y, transform.rows[2].y);
+    vec3 z = vec3(transform.rows[0].z, transform.rows[1].z, transform.rows[2].z);
+    return sqrt(max(dot(x, x), max(dot(y, y), dot(z, z))));
+}
+
+// center and radius are in world space
+bool sphereInFrustum(CullingViewBuffer cullingViews, uint viewIndex, vec3 center, float radius) {
+    for (int i = 0; i < 6; i++) {
+        if (dot(vec4(center, 1.0), cullingViews.views[viewIndex].planes[i]) + radius < 0.0)
+            return false;
+    }
+    return true;
+}
+
+// exact test of the oriented box the local aabb becomes under the transform. the box is projected onto each plane
+// normal along its transformed axes so rotation and non uniform scale don't inflate it.
+bool boxInFrustum(CullingViewBuffer cullingViews, uint viewIndex, AffineTransform transform, vec3 localMin, vec3 localMax) {
+    vec3 localCenter = (localMin + localMax) * 0.5;
+    vec3 localExtent = (localMax - localMin) * 0.5;
+    vec3 center = transformPoint(transform, localCenter);
+    vec3 axisX = vec3(transform.rows[0].x, transform.rows[1].x, transform.rows[2].x) * localExtent.x;
+    vec3 axisY = vec3(transform.rows[0].y, transform.rows[1].y, transform.rows[2].y) * localExtent.y;
+    vec3 axisZ = vec3(transform.rows[0].z, transform.rows[1].z, transform.rows[2].z) * localExtent.z;
+
+    for (int i = 0; i < 6; i++) {
+        vec4 plane = cullingViews.views[viewIndex].planes[i];
+        float radius = abs(dot(plane.xyz, axisX)) + abs(dot(plane.xyz, axisY)) + abs(dot(plane.xyz, axisZ));
+        if (dot(plane.xyz, center) + plane.w + radius < 0.0)
+            return false;
+    }
+    return true;
+}
+
+// conservative diameter in pixels of a world space sphere, negative when the sphere reaches the near plane
+float projectedSphereSize(CullingViewBuffer cullingViews, uint viewIndex, vec3 center, float radius, float screenHeight) {
+    CullingView view = cullingViews.views[viewIndex];
+    float distance = length((view.view * vec4(center, 1.0)).xyz);
+    if (distance - radius <= view.projection.z)
+        return -1.0;
+    return radius / (distance - radius) * view.projection.y * screenHeight;
+}
+
+// pixels covered by a lod error at its local space bounds. the distance is taken to the nearest point of the bounds
+// and clamped to the near plane so bounds around the camera project the largest error
+float projectedError(CullingView view, AffineTransform transform, vec3 center, float radius, float error, float screenHeight) {
+    float scale = maxScale(transform);
+    vec3 viewCenter = (view.view * vec4(transformPoint(transform, center), 1.0)).xyz;
+    float distance = max(length(viewCenter) - radius * scale, view.projection.z);
+    return error * scale / distance * view.projection.y * screenHeight * 0.5;
+}
+
+// a meshlet is in the lod cut when its own error is acceptable and its parent's isn't. parent bounds enclose their
+// children's and parent errors include their children's so exactly one meshlet along any path through the dag passes.
+// the cut is always chosen from the culling camera so every view of a frame draws the same geometry.
+// with geometry streaming the cut is made from the resident part of the dag. a group whose members are partly
+// streamed out draws its outputs whatever their error, and a group whose outputs are streamed out leaves the choice
+// to its members.
+bool lodVisible(GlobalData globalData, AffineTransform transform, Meshlet meshlet) {
+    CullingView view = globalData.cullingViewBufferRef.views[globalData.cullingCamera];
+    float screenHeight = float(globalData.screenSize.y);
+    float threshold = globalData.lodErrorThreshold;
+    bool lodAccepted = projectedError(view, transform, meshlet.lodCenter, meshlet.lodRadius, meshlet.lodError, screenHeight) <= threshold;
+    bool parentAccepted = projectedError(view, transform, meshlet.parentCenter, meshlet.parentRadius, meshlet.parentError, screenHeight) <= threshold;
+
+    if (uint64_t(globalData.meshletGroupBufferRef) != 0) {
+        if (meshlet.lodGroup != MESHLET_GROUP_NONE && (globalData.meshletGroupBufferRef.flags[meshlet.lodGroup] & MESHLET_GROUP_MEMBERS_RESIDENT) == 0)
+            lodAccepted = true;
+        if (meshlet.parentGroup != MESHLET_GROUP_NONE) {
+            uint parentFlags = globalData.meshletGroupBufferRef.flags[meshlet.parentGroup];
+            if ((parentFlags & MESHLET_GROUP_OUTPUTS_RESIDENT) == 0)
+                parentAccepted = false;
+            else if ((parentFlags & MESHLET_GROUP_MEMBERS_RESIDENT) == 0)
+                parentAccepted = true;
+        }
+    }
+    return lodAccepted && !parentAccepted;
+}
+
+// whether the cut would reach this meshlet's level or below if the whole dag was resident, used to request pages
+bool lodRequired(GlobalData globalData, AffineTransform transform, Meshlet meshlet) {
+    CullingView view = globalData.cullingViewBufferRef.views[globalData.cullingCamera];
+    return projectedError(view, transform, meshlet.parentCenter, meshlet.parentRadius, meshlet.parentError, float(globalData.screenSize.y)) > globalData.lodErrorThreshold;
+}
+
+// instance a culling thread reads. the alpha pass walks the alpha instances stored backwards from the end of the
+// buffer. the opaque pass walks the opaque instances and then the alpha ones again, so meshlets of alpha tested meshes
+// that were found fully opaque at import are drawn without the alpha test. fromAlpha is set for alpha list instances.
+uint cullingInstanceIndex(uint threadIndex, uint opaqueCount, uint alphaCount, uint maxMeshletCount, bool alphaPass, out bool fromAlpha) {
+    uint alphaOffset = maxMeshletCount - alphaCount;
+    fromAlpha = alphaPass || threadIndex >= opaqueCount;
+    if (alphaPass)
+        return alphaOffset + threadIndex;
+    if (threadIndex >= opaqueCount)
+        return alphaOffset + (threadIndex - opaqueCount);
+    return threadIndex;
+}
+
+uint cullingInstanceCount(uint opaqueCount, uint alphaCount, bool alphaPass) {
+    return alphaPass ? alphaCount : opaqueCount + alphaCount;
+}
+
+// alpha list meshlets are culled by exactly one pass, the opaque pass when flagged opaque and the alpha pass otherwise
+bool meshletInPass(Meshlet meshlet, bool alphaPass, bool fromAlpha) {
+    bool opaque = (meshlet.flags & MESHLET_FLAG_OPAQUE) != 0;
+    return !fromAlpha || opaque != alphaPass;
+}
+
+// backface cone test from
+// https://github.com/zeux/niagara/blob/master/src/shaders/meshlet.task.glsl
+bool coneCull(vec3 center, float radius, vec3 coneAxis, float coneCutoff, vec3 cameraPosition) {
+    return dot(center - cameraPosition, coneAxis) >= coneCutoff * length(center - cameraPosition) + radius;
+}
+
+#endif //CULLING_GLSL
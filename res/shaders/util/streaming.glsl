@@ -0,0 +1,34 @@
+#ifndef STREAMING_GLSL
+#define STREAMING_GLSL
+
+// geometry streaming feedback written while culling. expects cen.glsl and util/culling.glsl to be included first.
+
+bool meshletResident(GlobalData globalData, Meshlet meshlet) {
+    if (uint64_t(globalData.meshletPageBufferRef) == 0 || meshlet.page == MESHLET_PAGE_NONE)
+        return true;
+    return globalData.meshletPageBufferRef.slots[meshlet.page] != MESHLET_PAGE_NONE;
+}
+
+// requests are kept in a small hashed set so the many meshlets of one page only take a single entry
+void requestPage(PageFeedbackBuffer feedback, uint page) {
+    uint entry = (page * 2654435761u) % MAX_PAGE_REQUESTS;
+    for (uint i = 0; i < 8; i++) {
+        uint previous = atomicCompSwap(feedback.requests[entry], MESHLET_PAGE_NONE, page);
+        if (previous == MESHLET_PAGE_NONE || previous == page)
+            return;
+        entry = (entry + 1) % MAX_PAGE_REQUESTS;
+    }
+}
+
+// for meshlets inside the view, marks the page of drawn meshlets as used so it isn't evicted and requests the page
+// of meshlets the lod cut needs that are streamed out
+void streamMeshlet(GlobalData globalData, AffineTransform transform, Meshlet meshlet, bool resident, bool drawn) {
+    if (uint64_t(globalData.pageFeedbackBufferRef) == 0 || meshlet.page == MESHLET_PAGE_NONE)
+        return;
+    if (drawn)
+        globalData.pageFeedbackBufferRef.slotUsage[globalData.meshletPageBufferRef.slots[meshlet.page]] = 1;
+    else if (!resident && lodRequired(globalData, transform, meshlet))
+        requestPage(globalData.pageFeedbackBufferRef, meshlet.page);
+}
+
+#endif //STREAMING_GLSL
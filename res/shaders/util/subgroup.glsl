@@ -0,0 +1,33 @@
+#ifndef SUBGROUP_GLSL
+#define SUBGROUP_GLSL
+
+// requires GL_KHR_shader_subgroup_ballot and GL_KHR_shader_subgroup_arithmetic.
+// these aggregate over the active invocations of a subgroup so they issue a single atomic per subgroup.
+// all invocations that could contribute have to reach the call together.
+
+// adds value from every active invocation to counter
+#define subgroupAtomicAdd(counter, value) { \
+    uint subgroupTotal_ = subgroupAdd(value); \
+    if (subgroupElect() && subgroupTotal_ > 0) \
+        atomicAdd(counter, subgroupTotal_); \
+}
+
+// reserves one slot of counter for every active invocation with predicate set, writing the slot to index.
+// index is only meaningful on invocations where predicate is true
+#define subgroupAtomicAppend(counter, predicate, index) { \
+    uvec4 ballot_ = subgroupBallot(predicate); \
+    uint appendCount_ = subgroupBallotBitCount(ballot_); \
+    uint base_ = 0; \
+    if (subgroupElect() && appendCount_ > 0) \
+        base_ = atomicAdd(counter, appendCount_); \
+    index = subgroupBroadcastFirst(base_) + subgroupBallotExclusiveBitCount(ballot_); \
+}
+
+// counters only feed the statistics window, builds without CULLING_STATS drop them entirely
+#ifdef CULLING_STATS
+#define cullingStat(counter, value) subgroupAtomicAdd(counter, value)
+#else
+#define cullingStat(counter, value)
+#endif
+
+#endif //SUBGROUP_GLSL
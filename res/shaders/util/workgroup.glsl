@@ -0,0 +1,50 @@
+#ifndef WORKGROUP_GLSL
+#define WORKGROUP_GLSL
+
+// lets a dispatch write its own indirect arguments instead of following it with a single workgroup pass.
+// every invocation of the workgroup has to reach lastWorkgroup together as it contains barriers.
+
+shared bool sharedLastWorkgroup;
+
+// sets result in every invocation of the last workgroup of the dispatch to finish. buffer writes of each workgroup
+// are made visible before it signals, so the last workgroup can read the results of the whole dispatch.
+// counter has to be zeroed before the dispatch
+#define lastWorkgroup(counter, result) { \
+    memoryBarrierBuffer(); \
+    barrier(); \
+    if (gl_LocalInvocationIndex == 0) { \
+        uint workgroupCount_ = gl_NumWorkGroups.x * gl_NumWorkGroups.y * gl_NumWorkGroups.z; \
+        sharedLastWorkgroup = atomicAdd(counter, 1) == workgroupCount_ - 1; \
+    } \
+    barrier(); \
+    result = sharedLastWorkgroup; \
+}
+
+// one thread per item in 64 wide workgroups. at least one workgroup is always launched so the
+// dispatch still runs, and still writes the commands that follow it, when there is nothing to process.
+// the workgroups are spread over a grid as a single row passes the per dimension limit at around 4 million items,
+// shaders dispatched with it index items with linearIndex()
+DispatchIndirectCommand linearCommand(uint count) {
+    uint workgroups = max(1, (count + 63) / 64);
+    DispatchIndirectCommand command;
+    command.x = max(1, uint(ceil(sqrt(float(workgroups)))));
+    command.y = (workgroups + command.x - 1) / command.x;
+    command.z = 1;
+    return command;
+}
+
+// item index of the invocation in a dispatch written by linearCommand
+uint linearIndex() {
+    return (gl_WorkGroupID.x + gl_NumWorkGroups.x * gl_WorkGroupID.y) * 64 + gl_LocalInvocationIndex;
+}
+
+// one workgroup per item spread over a square grid to stay within the per dimension workgroup limit
+DispatchIndirectCommand gridCommand(uint workgroups) {
+    DispatchIndirectCommand command;
+    command.x = max(1, uint(ceil(sqrt(float(workgroups)))));
+    command.y = command.x;
+    command.z = 1;
+    return command;
+}
+
+#endif //WORKGROUP_GLSL
@@ -0,0 +1,22 @@
+#ifndef SOFTWARE_RASTER_GLSL
+#define SOFTWARE_RASTER_GLSL
+
+// each pixel packs the reverse z depth above the visibility id so a single 64 bit atomicMax keeps the nearest
+// fragment. depth is never negative so its bits order the same as the float, and a cleared pixel is zero.
+declareBufferReference(SoftwareVisibilityBuffer,
+    uint64_t pixels[];
+);
+
+uint64_t packSoftwareFragment(float depth, uint visibility) {
+    return (uint64_t(floatBitsToUint(depth)) << 32) | uint64_t(visibility);
+}
+
+float unpackSoftwareDepth(uint64_t fragment) {
+    return uintBitsToFloat(uint(fragment >> 32));
+}
+
+uint unpackSoftwareVisibility(uint64_t fragment) {
+    return uint(fragment & 0xFFFFFFFFUL);
+}
+
+#endif //SOFTWARE_RASTER_GLSL
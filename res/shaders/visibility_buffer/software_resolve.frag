@@ -0,0 +1,26 @@
+#version 460
+
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : enable
+
+#include "cen.glsl"
+#include "visibility_buffer/software_raster.glsl"
+
+layout (push_constant) uniform Push {
+    SoftwareVisibilityBuffer visibilityBuffer;
+    uint width;
+    int padding;
+};
+
+layout (location = 0) out uint VisibilityInfo;
+
+// merges the software rasterised fragments into the hardware visibility and depth targets, the depth test keeps
+// whichever is nearer
+void main() {
+    ivec2 coords = ivec2(gl_FragCoord.xy);
+    uint64_t fragment = visibilityBuffer.pixels[coords.y * width + coords.x];
+    if (fragment == 0)
+        discard;
+
+    gl_FragDepth = unpackSoftwareDepth(fragment);
+    VisibilityInfo = unpackSoftwareVisibility(fragment);
+}
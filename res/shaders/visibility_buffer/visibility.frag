@@ -18,10 +18,14 @@ layout (push_constant) uniform Push {
     GlobalDataRef globalDataRef;
     MeshletInstanceBuffer meshletInstanceBuffer;
     int alphaPass;
+    int cameraIndex;
+    int cullingCameraIndex;
     int padding;
 };
 
+#ifndef DEPTH_ONLY
 layout (location = 0) out uint VisibilityInfo;
+#endif
 
 void main() {
     #ifdef ALPHA_TEST
@@ -33,7 +37,7 @@ void main() {
 //        int x = int(gl_FragCoord.x) % 4;
 //        int y = int(gl_FragCoord.y) % 4;
 //        int index = x + y * 4;
-        float limit = 0.8;
+        float limit = ALPHA_TEST_THRESHOLD;
 //        if (x < 8) {
 //            if (index == 0) limit = 0.0625;
 //            if (index == 1) limit = 0.5625;
@@ -60,7 +64,9 @@ void main() {
     #endif
 
 
+    #ifndef DEPTH_ONLY
     uint visibility = setMeshletId(fsIn.meshletId);
     visibility |= setPrimitiveId(gl_PrimitiveID);
     VisibilityInfo = visibility;
+    #endif
 }
\ No newline at end of file
@@ -129,6 +129,7 @@ struct InterpolatedValues {
     vec3 normal;
     UVGradient uvGrad;
     mat3 TBN;
+    uint clusterIndex;
 };
 
 
@@ -11,6 +11,10 @@
 #include <ktx.h>
 #include <rapidjson/document.h>
 #include <stack>
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <algorithm>
 #include <span>
 #include <cen.glsl>
 
@@ -58,6 +62,7 @@ auto cen::AssetManager::create(cen::AssetManager::CreateInfo info) -> AssetManag
     manager._engine = info.engine;
     manager._assetMutex = std::make_unique<std::mutex>();
     manager._rootPath = info.rootPath;
+    manager._importSettings = info.importSettings;
     manager._models.reserve(5);
 
     return manager;
@@ -212,11 +217,601 @@ auto cen::AssetManager::loadImageAsync(const std::filesystem::path &path, canta:
     }, path, format);
 }
 
+// meshlets of a single primitive. indexOffset and primitiveOffset are relative to indices and primitives, which
+// hold indices into the primitive's own vertices
+struct MeshletGroup {
+    std::vector<u32> members = {};
+    u32 firstOutput = 0;
+    u32 outputCount = 0;
+};
+struct MeshletData {
+    cen::MeshletSize size = {};
+    cen::AssetManager::MeshletBuilder builder = cen::AssetManager::MeshletBuilder::GREEDY;
+    std::vector<Meshlet> meshlets = {};
+    std::vector<u32> indices = {};
+    std::vector<u8> primitives = {};
+    // dag groups in the order they were simplified, a group's outputs are consecutive meshlets
+    std::vector<MeshletGroup> groups = {};
+};
+
+// builds meshlets from a triangle list with meshopt's greedy builder and appends them to data, returns the number of
+// meshlets added. optimise reorders each meshlet's vertices and triangles for locality within the meshlet
+auto buildMeshlets(MeshletData& data, std::span<const u32> indices, std::span<const Vertex> vertices, bool optimise) -> u32 {
+    const f32 coneWeight = 0.25f;
+
+    u32 maxMeshlets = meshopt_buildMeshletsBound(indices.size(), data.size.vertices, data.size.primitives);
+    std::vector<meshopt_Meshlet> meshoptMeshlets(maxMeshlets);
+    std::vector<u32> meshletIndices(maxMeshlets * data.size.vertices);
+    std::vector<u8> meshletPrimitives(maxMeshlets * data.size.primitives * 3);
+
+    u32 meshletCount = meshopt_buildMeshlets(meshoptMeshlets.data(), meshletIndices.data(), meshletPrimitives.data(), indices.data(), indices.size(), (f32*)vertices.data(), vertices.size(), sizeof(Vertex), data.size.vertices, data.size.primitives, coneWeight);
+    if (meshletCount == 0)
+        return 0;
+
+    auto& lastMeshlet = meshoptMeshlets[meshletCount - 1];
+    meshletIndices.resize(lastMeshlet.vertex_offset + lastMeshlet.vertex_count);
+    meshletPrimitives.resize(lastMeshlet.triangle_offset + ((lastMeshlet.triangle_count * 3 + 3) & ~3));
+    meshoptMeshlets.resize(meshletCount);
+
+    if (optimise) {
+        for (auto& meshlet : meshoptMeshlets)
+            meshopt_optimizeMeshlet(&meshletIndices[meshlet.vertex_offset], &meshletPrimitives[meshlet.triangle_offset], meshlet.triangle_count, meshlet.vertex_count);
+    }
+
+    // meshopt keeps triangle offsets 4 byte aligned so appending preserves the alignment
+    u32 indexOffset = data.indices.size();
+    u32 primitiveOffset = data.primitives.size();
+    for (auto& meshlet : meshoptMeshlets) {
+        auto bounds = meshopt_computeMeshletBounds(&meshletIndices[meshlet.vertex_offset], &meshletPrimitives[meshlet.triangle_offset], meshlet.triangle_count, (f32*)vertices.data(), vertices.size(), sizeof(Vertex));
+
+        ende::math::Vec3f center = { bounds.center[0], bounds.center[1], bounds.center[2] };
+
+        data.meshlets.push_back({
+            .vertexOffset = 0,
+            .indexOffset = meshlet.vertex_offset + indexOffset,
+            .indexCount = meshlet.vertex_count,
+            .primitiveOffset = meshlet.triangle_offset + primitiveOffset,
+            .primitiveCount = meshlet.triangle_count,
+            .center = center,
+            .radius = bounds.radius,
+            .coneAxis = { bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2] },
+            .coneCutoff = bounds.cone_cutoff,
+            .lodCenter = center,
+            .lodRadius = bounds.radius,
+            .lodError = 0,
+            .parentCenter = center,
+            .parentRadius = bounds.radius,
+            .parentError = MESHLET_ROOT_ERROR,
+            .page = MESHLET_PAGE_NONE,
+            .lodGroup = MESHLET_GROUP_NONE,
+            .parentGroup = MESHLET_GROUP_NONE,
+            .flags = 0
+        });
+    }
+
+    data.indices.insert(data.indices.end(), meshletIndices.begin(), meshletIndices.end());
+    data.primitives.insert(data.primitives.end(), meshletPrimitives.begin(), meshletPrimitives.end());
+    return meshletCount;
+}
+
+// reorders the triangles of indices by a k-d split on their centroids. nodes are halved at the median of their longest
+// axis until their triangles and vertices fit in a single meshlet. returns the leaves as triangle ranges, in depth
+// first order so neighbouring leaves stay close in space.
+auto splitSpatially(std::vector<u32>& indices, std::span<const Vertex> vertices, cen::MeshletSize size) -> std::vector<std::pair<u32, u32>> {
+    const u32 triangleCount = indices.size() / 3;
+    std::vector<u32> triangles(triangleCount);
+    std::vector<std::array<f32, 3>> centroids(triangleCount);
+    for (u32 triangle = 0; triangle < triangleCount; triangle++) {
+        triangles[triangle] = triangle;
+        auto& a = vertices[indices[triangle * 3 + 0]].position;
+        auto& b = vertices[indices[triangle * 3 + 1]].position;
+        auto& c = vertices[indices[triangle * 3 + 2]].position;
+        centroids[triangle] = { (a.x() + b.x() + c.x()) / 3, (a.y() + b.y() + c.y()) / 3, (a.z() + b.z() + c.z()) / 3 };
+    }
+
+    std::vector<std::pair<u32, u32>> leaves = {};
+    std::vector<u32> vertexStamps(vertices.size(), ~0u);
+    u32 stamp = 0;
+    std::stack<std::pair<u32, u32>> nodes = {};
+    nodes.push({ 0, triangleCount });
+    while (!nodes.empty()) {
+        auto [begin, end] = nodes.top();
+        nodes.pop();
+
+        if (end - begin <= size.primitives) {
+            u32 vertexCount = 0;
+            for (u32 i = begin; i < end; i++) {
+                for (u32 corner = 0; corner < 3; corner++) {
+                    u32 vertex = indices[triangles[i] * 3 + corner];
+                    if (vertexStamps[vertex] != stamp) {
+                        vertexStamps[vertex] = stamp;
+                        vertexCount++;
+                    }
+                }
+            }
+            stamp++;
+            if (vertexCount <= size.vertices || end - begin == 1) {
+                leaves.push_back({ begin, end });
+                continue;
+            }
+        }
+
+        std::array<f32, 3> min = { std::numeric_limits<f32>::max(), std::numeric_limits<f32>::max(), std::numeric_limits<f32>::max() };
+        std::array<f32, 3> max = { std::numeric_limits<f32>::lowest(), std::numeric_limits<f32>::lowest(), std::numeric_limits<f32>::lowest() };
+        for (u32 i = begin; i < end; i++) {
+            for (u32 axis = 0; axis < 3; axis++) {
+                min[axis] = std::min(min[axis], centroids[triangles[i]][axis]);
+                max[axis] = std::max(max[axis], centroids[triangles[i]][axis]);
+            }
+        }
+        u32 axis = 0;
+        for (u32 i = 1; i < 3; i++) {
+            if (max[i] - min[i] > max[axis] - min[axis])
+                axis = i;
+        }
+
+        const u32 middle = begin + (end - begin) / 2;
+        std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end, [&centroids, axis] (u32 a, u32 b) {
+            return centroids[a][axis] < centroids[b][axis];
+        });
+        nodes.push({ middle, end });
+        nodes.push({ begin, middle });
+    }
+
+    std::vector<u32> orderedIndices(indices.size());
+    for (u32 i = 0; i < triangleCount; i++) {
+        for (u32 corner = 0; corner < 3; corner++)
+            orderedIndices[i * 3 + corner] = indices[triangles[i] * 3 + corner];
+    }
+    indices = std::move(orderedIndices);
+    return leaves;
+}
+
+// splits a triangle list into meshlets appended to data with the builder data was set up with, returns the number of
+// meshlets added
+auto appendMeshlets(MeshletData& data, std::span<const u32> indices, std::span<const Vertex> vertices, bool optimise) -> u32 {
+    if (data.builder != cen::AssetManager::MeshletBuilder::SPATIAL)
+        return buildMeshlets(data, indices, vertices, optimise);
+
+    // every leaf fits a meshlet so the greedy builder only has to pack its triangles
+    std::vector<u32> orderedIndices(indices.begin(), indices.end());
+    u32 meshletCount = 0;
+    for (auto [begin, end] : splitSpatially(orderedIndices, vertices, data.size))
+        meshletCount += buildMeshlets(data, std::span(orderedIndices).subspan(begin * 3, (end - begin) * 3), vertices, optimise);
+    return meshletCount;
+}
+
+// smallest sphere around both spheres
+auto mergeSpheres(ende::math::Vec4f a, ende::math::Vec4f b) -> ende::math::Vec4f {
+    f32 dx = b.x() - a.x();
+    f32 dy = b.y() - a.y();
+    f32 dz = b.z() - a.z();
+    f32 distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (distance + b.w() <= a.w())
+        return a;
+    if (distance + a.w() <= b.w())
+        return b;
+    f32 radius = (distance + a.w() + b.w()) * 0.5f;
+    f32 t = (radius - a.w()) / distance;
+    return { a.x() + dx * t, a.y() + dy * t, a.z() + dz * t, radius };
+}
+
+// builds the cluster dag above the source meshlets in data. groups of neighbouring meshlets are merged, simplified to
+// half their triangles with the group border locked and split back into meshlets, level by level until one meshlet
+// is left or nothing simplifies. locking the border keeps neighbouring groups watertight whichever level each is
+// drawn at. a group's bounds enclose its children's and its error adds to theirs so errors only grow towards the root.
+void buildClusterDag(MeshletData& data, std::span<const Vertex> vertices, bool optimise) {
+    constexpr u32 groupSize = 4;
+    constexpr f32 minReduction = 0.85f;
+
+    // vertices split along uv or normal seams still connect their meshlets, so adjacency is found by position
+    std::vector<u32> positionIds(vertices.size());
+    meshopt_Stream positionStream = { vertices.data(), sizeof(ende::math::Vec3f), sizeof(Vertex) };
+    u32 positionCount = meshopt_generateVertexRemapMulti(positionIds.data(), nullptr, vertices.size(), vertices.size(), &positionStream, 1);
+
+    const f32 errorScale = meshopt_simplifyScale((f32*)vertices.data(), vertices.size(), sizeof(Vertex));
+
+    std::vector<u32> level(data.meshlets.size());
+    for (u32 i = 0; i < level.size(); i++)
+        level[i] = i;
+
+    std::vector<std::vector<u32>> positionMeshlets(positionCount);
+    std::vector<u32> groupIndices = {};
+    std::vector<u32> simplifiedIndices = {};
+    while (level.size() > 1) {
+        for (auto& meshlets : positionMeshlets)
+            meshlets.clear();
+        for (u32 i = 0; i < level.size(); i++) {
+            auto& meshlet = data.meshlets[level[i]];
+            for (u32 j = 0; j < meshlet.indexCount; j++) {
+                auto& meshlets = positionMeshlets[positionIds[data.indices[meshlet.indexOffset + j]]];
+                if (meshlets.empty() || meshlets.back() != i)
+                    meshlets.push_back(i);
+            }
+        }
+
+        // greedily grow each group from a seed by the ungrouped meshlet sharing the most vertices with it
+        std::vector<bool> grouped(level.size(), false);
+        std::vector<std::vector<u32>> groups = {};
+        std::unordered_map<u32, u32> sharedCounts = {};
+        for (u32 seed = 0; seed < level.size(); seed++) {
+            if (grouped[seed])
+                continue;
+            auto& group = groups.emplace_back();
+            group.push_back(seed);
+            grouped[seed] = true;
+
+            while (group.size() < groupSize) {
+                sharedCounts.clear();
+                for (u32 member : group) {
+                    auto& meshlet = data.meshlets[level[member]];
+                    for (u32 j = 0; j < meshlet.indexCount; j++) {
+                        for (u32 neighbour : positionMeshlets[positionIds[data.indices[meshlet.indexOffset + j]]]) {
+                            if (!grouped[neighbour])
+                                sharedCounts[neighbour]++;
+                        }
+                    }
+                }
+                if (sharedCounts.empty())
+                    break;
+                auto best = std::max_element(sharedCounts.begin(), sharedCounts.end(), [](auto& a, auto& b) {
+                    return a.second < b.second || (a.second == b.second && a.first > b.first);
+                });
+                group.push_back(best->first);
+                grouped[best->first] = true;
+            }
+        }
+
+        std::vector<u32> nextLevel = {};
+        for (auto& group : groups) {
+            groupIndices.clear();
+            ende::math::Vec4f groupSphere = {};
+            f32 childError = 0;
+            for (u32 i = 0; auto member : group) {
+                auto& meshlet = data.meshlets[level[member]];
+                for (u32 j = 0; j < meshlet.primitiveCount * 3; j++)
+                    groupIndices.push_back(data.indices[meshlet.indexOffset + data.primitives[meshlet.primitiveOffset + j]]);
+                ende::math::Vec4f lodSphere = { meshlet.lodCenter.x(), meshlet.lodCenter.y(), meshlet.lodCenter.z(), meshlet.lodRadius };
+                groupSphere = i++ == 0 ? lodSphere : mergeSpheres(groupSphere, lodSphere);
+                childError = std::max(childError, meshlet.lodError);
+            }
+
+            simplifiedIndices.resize(groupIndices.size());
+            f32 simplifyError = 0;
+            u32 targetIndexCount = (groupIndices.size() / 6) * 3;
+            u32 simplifiedCount = meshopt_simplify(simplifiedIndices.data(), groupIndices.data(), groupIndices.size(), (f32*)vertices.data(), vertices.size(), sizeof(Vertex), targetIndexCount, 1.f, meshopt_SimplifyLockBorder, &simplifyError);
+            // groups that barely simplify are left as roots rather than adding levels that save nothing
+            if (simplifiedCount == 0 || simplifiedCount > groupIndices.size() * minReduction)
+                continue;
+
+            const f32 groupError = childError + simplifyError * errorScale;
+            const ende::math::Vec3f groupCenter = { groupSphere.x(), groupSphere.y(), groupSphere.z() };
+            auto& dagGroup = data.groups.emplace_back();
+            for (auto member : group) {
+                auto& meshlet = data.meshlets[level[member]];
+                meshlet.parentCenter = groupCenter;
+                meshlet.parentRadius = groupSphere.w();
+                meshlet.parentError = groupError;
+                dagGroup.members.push_back(level[member]);
+            }
+
+            u32 firstMeshlet = data.meshlets.size();
+            u32 meshletCount = appendMeshlets(data, std::span(simplifiedIndices.data(), simplifiedCount), vertices, optimise);
+            data.groups.back().firstOutput = firstMeshlet;
+            data.groups.back().outputCount = meshletCount;
+            for (u32 i = firstMeshlet; i < firstMeshlet + meshletCount; i++) {
+                data.meshlets[i].lodCenter = groupCenter;
+                data.meshlets[i].lodRadius = groupSphere.w();
+                data.meshlets[i].lodError = groupError;
+                nextLevel.push_back(i);
+            }
+        }
+        level = std::move(nextLevel);
+    }
+}
+
+// alpha channel of a material's base colour texture, read back at import to classify meshlets
+struct AlphaMask {
+    u32 width = 0;
+    u32 height = 0;
+    std::vector<u8> alpha = {};
+};
+
+// only uncompressed or basis textures can be read back, anything else leaves the mask empty
+auto loadAlphaMask(const std::filesystem::path& path) -> AlphaMask {
+    AlphaMask mask = {};
+    if (path.extension() == ".ktx2") {
+        ktxTexture2* texture = nullptr;
+        if (ktxTexture2_CreateFromNamedFile(path.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) != ktxResult::KTX_SUCCESS)
+            return mask;
+        bool readable = true;
+        if (ktxTexture2_NeedsTranscoding(texture))
+            readable = ktxTexture2_TranscodeBasis(texture, KTX_TTF_RGBA32, KTX_TF_HIGH_QUALITY) == ktxResult::KTX_SUCCESS;
+        else
+            readable = static_cast<canta::Format>(texture->vkFormat) == canta::Format::RGBA8_UNORM || static_cast<canta::Format>(texture->vkFormat) == canta::Format::RGBA8_SRGB;
+        if (readable) {
+            size_t offset = 0;
+            ktxTexture_GetImageOffset(reinterpret_cast<ktxTexture*>(texture), 0, 0, 0, &offset);
+            u8* data = ktxTexture_GetData(reinterpret_cast<ktxTexture*>(texture)) + offset;
+            mask.width = texture->baseWidth;
+            mask.height = texture->baseHeight;
+            mask.alpha.resize(mask.width * mask.height);
+            for (u32 i = 0; i < mask.alpha.size(); i++)
+                mask.alpha[i] = data[i * 4 + 3];
+        }
+        ktxTexture_Destroy(reinterpret_cast<ktxTexture*>(texture));
+        return mask;
+    }
+
+    i32 width = 0;
+    i32 height = 0;
+    i32 channels = 0;
+    u8* data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (!data)
+        return mask;
+    mask.width = width;
+    mask.height = height;
+    mask.alpha.resize(mask.width * mask.height);
+    for (u32 i = 0; i < mask.alpha.size(); i++)
+        mask.alpha[i] = data[i * 4 + 3];
+    stbi_image_free(data);
+    return mask;
+}
+
+// flags meshlets whose triangles only cover texels that pass the alpha test so they can be drawn as opaque. each
+// triangle's uv bounds are widened by a texel for filtering and wrapped like the repeat sampler. meshlets covering
+// more texels than the budget stay alpha tested.
+void classifyAlpha(MeshletData& data, std::span<const Vertex> vertices, const AlphaMask& mask) {
+    constexpr u64 texelBudget = 1 << 20;
+    if (mask.alpha.empty())
+        return;
+
+    const u8 threshold = static_cast<u8>(std::min(255.f, std::ceil(ALPHA_TEST_THRESHOLD * 255.f)));
+    const i64 width = mask.width;
+    const i64 height = mask.height;
+    for (auto& meshlet : data.meshlets) {
+        bool opaque = true;
+        u64 texels = 0;
+        for (u32 triangle = 0; opaque && triangle < meshlet.primitiveCount; triangle++) {
+            f32 minU = std::numeric_limits<f32>::max();
+            f32 minV = std::numeric_limits<f32>::max();
+            f32 maxU = std::numeric_limits<f32>::lowest();
+            f32 maxV = std::numeric_limits<f32>::lowest();
+            for (u32 corner = 0; corner < 3; corner++) {
+                auto& uv = vertices[data.indices[meshlet.indexOffset + data.primitives[meshlet.primitiveOffset + triangle * 3 + corner]]].uv;
+                minU = std::min(minU, uv.x());
+                minV = std::min(minV, uv.y());
+                maxU = std::max(maxU, uv.x());
+                maxV = std::max(maxV, uv.y());
+            }
+            const i64 minX = static_cast<i64>(std::floor(minU * width)) - 1;
+            const i64 minY = static_cast<i64>(std::floor(minV * height)) - 1;
+            const i64 maxX = static_cast<i64>(std::floor(maxU * width)) + 1;
+            const i64 maxY = static_cast<i64>(std::floor(maxV * height)) + 1;
+            texels += (maxX - minX + 1) * (maxY - minY + 1);
+            if (texels > texelBudget) {
+                opaque = false;
+                break;
+            }
+            for (i64 y = minY; opaque && y <= maxY; y++) {
+                const i64 row = ((y % height) + height) % height;
+                for (i64 x = minX; x <= maxX; x++) {
+                    if (mask.alpha[row * width + ((x % width) + width) % width] < threshold) {
+                        opaque = false;
+                        break;
+                    }
+                }
+            }
+        }
+        if (opaque)
+            meshlet.flags |= MESHLET_FLAG_OPAQUE;
+    }
+}
+
+// import time optimisation of a primitive's triangle list. exact duplicate vertices are welded, triangles reordered
+// for the post transform cache and then for overdraw within its cache budget, and vertices reordered into first use
+// order so fetches stay local. unused vertices are dropped.
+void optimiseGeometry(std::vector<Vertex>& vertices, std::vector<u32>& indices, const cen::AssetManager::ImportSettings& settings) {
+    if (indices.empty())
+        return;
+
+    if (settings.weldVertices) {
+        std::vector<u32> remap(vertices.size());
+        u32 vertexCount = meshopt_generateVertexRemap(remap.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex));
+        meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+        meshopt_remapVertexBuffer(vertices.data(), vertices.data(), vertices.size(), sizeof(Vertex), remap.data());
+        vertices.resize(vertexCount);
+    }
+    if (settings.optimiseVertexCache)
+        meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+    if (settings.optimiseOverdraw)
+        meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), (f32*)vertices.data(), vertices.size(), sizeof(Vertex), 1.05f);
+    if (settings.optimiseVertexFetch) {
+        u32 vertexCount = meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex));
+        vertices.resize(vertexCount);
+    }
+}
+
+// adds a primitive's full detail geometry and meshlets to the model statistics, ratios are kept as triangle weighted
+// averages so primitives can be added one at a time
+void analyseGeometry(std::span<const Vertex> vertices, std::span<const u32> indices, std::span<const Meshlet> meshlets, cen::MeshletSize meshletSize, cen::Model::Statistics& statistics) {
+    const u32 triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || meshlets.empty())
+        return;
+
+    auto cache = meshopt_analyzeVertexCache(indices.data(), indices.size(), vertices.size(), 16, 0, 0);
+    auto overdraw = meshopt_analyzeOverdraw(indices.data(), indices.size(), (f32*)vertices.data(), vertices.size(), sizeof(Vertex));
+    auto fetch = meshopt_analyzeVertexFetch(indices.data(), indices.size(), vertices.size(), sizeof(Vertex));
+
+    f32 vertexFill = 0;
+    f32 primitiveFill = 0;
+    f32 meshletRadius = 0;
+    for (auto& meshlet : meshlets) {
+        vertexFill += static_cast<f32>(meshlet.indexCount) / meshletSize.vertices;
+        primitiveFill += static_cast<f32>(meshlet.primitiveCount) / meshletSize.primitives;
+        meshletRadius += meshlet.radius;
+    }
+    vertexFill /= meshlets.size();
+    primitiveFill /= meshlets.size();
+    meshletRadius /= meshlets.size();
+
+    const f32 weight = static_cast<f32>(triangleCount) / (statistics.triangleCount + triangleCount);
+    auto accumulate = [weight] (f32& average, f32 value) {
+        average += (value - average) * weight;
+    };
+    accumulate(statistics.acmr, cache.acmr);
+    accumulate(statistics.atvr, cache.atvr);
+    accumulate(statistics.overdraw, overdraw.overdraw);
+    accumulate(statistics.overfetch, fetch.overfetch);
+    accumulate(statistics.vertexFill, vertexFill);
+    accumulate(statistics.primitiveFill, primitiveFill);
+    accumulate(statistics.meshletRadius, meshletRadius);
+    statistics.vertexCount += vertices.size();
+    statistics.triangleCount += triangleCount;
+    statistics.meshletCount += meshlets.size();
+}
+
+// moves the geometry of the given meshlets into packed arrays, keeping only the vertices they reference. offsets of
+// the packed meshlets are into the packed arrays with indices relative to the first vertex packed
+void packMeshlets(const MeshletData& data, std::span<const Vertex> vertices, std::span<const u32> meshletIds, std::vector<Meshlet>& packedMeshlets, std::vector<Vertex>& packedVertices, std::vector<u32>& packedIndices, std::vector<u8>& packedPrimitives) {
+    const u32 vertexOffset = packedVertices.size();
+    std::vector<u32> vertexRemap(vertices.size(), ~0u);
+    for (auto id : meshletIds) {
+        Meshlet meshlet = data.meshlets[id];
+        const u32 indexOffset = packedIndices.size();
+        for (u32 i = 0; i < meshlet.indexCount; i++) {
+            const u32 vertex = data.indices[meshlet.indexOffset + i];
+            if (vertexRemap[vertex] == ~0u) {
+                vertexRemap[vertex] = packedVertices.size() - vertexOffset;
+                packedVertices.push_back(vertices[vertex]);
+            }
+            packedIndices.push_back(vertexRemap[vertex]);
+        }
+        // triangle offsets are kept 4 byte aligned like meshopt leaves them
+        const u32 primitiveOffset = packedPrimitives.size();
+        packedPrimitives.insert(packedPrimitives.end(), data.primitives.begin() + meshlet.primitiveOffset, data.primitives.begin() + meshlet.primitiveOffset + meshlet.primitiveCount * 3);
+        packedPrimitives.resize(primitiveOffset + ((meshlet.primitiveCount * 3 + 3) & ~3));
+
+        meshlet.vertexOffset = vertexOffset;
+        meshlet.indexOffset = indexOffset;
+        meshlet.primitiveOffset = primitiveOffset;
+        packedMeshlets.push_back(meshlet);
+    }
+}
+
+// splits a primitive's meshlets into streamed pages. pages are filled with whole units, a source meshlet or the
+// outputs of one dag group, so every group's outputs are streamed together. meshlets at a root of the dag stay
+// resident so there is always something to draw, as do units too large for a page. data.meshlets is reordered with
+// the resident meshlets first, packed into the resident arrays, followed by each page's meshlets in order.
+// firstMeshlet is the model's meshlet index of the primitive's first meshlet.
+void splitPages(MeshletData& data, std::span<const Vertex> vertices, u32 firstMeshlet, cen::GeometryStreamer::PageSet& pageSet, std::vector<Vertex>& residentVertices, std::vector<u32>& residentIndices, std::vector<u8>& residentPrimitives) {
+    const u32 firstPage = pageSet.pages.size();
+    const u32 firstGroup = pageSet.groups.size();
+
+    std::vector<u32> lodGroups(data.meshlets.size(), MESHLET_GROUP_NONE);
+    for (u32 i = 0; auto& group : data.groups) {
+        for (u32 j = 0; j < group.outputCount; j++)
+            lodGroups[group.firstOutput + j] = i;
+        i++;
+    }
+
+    std::vector<u32> resident = {};
+    std::vector<std::vector<u32>> pages = {};
+    std::vector<u32> unit = {};
+    for (u32 i = 0; i < data.meshlets.size();) {
+        u32 end = i + 1;
+        if (lodGroups[i] != MESHLET_GROUP_NONE)
+            end = data.groups[lodGroups[i]].firstOutput + data.groups[lodGroups[i]].outputCount;
+        unit.clear();
+        for (; i < end; i++) {
+            if (data.meshlets[i].parentError == static_cast<f32>(MESHLET_ROOT_ERROR))
+                resident.push_back(i);
+            else
+                unit.push_back(i);
+        }
+        if (unit.empty())
+            continue;
+        if (unit.size() > cen::MESHLET_PAGE_MESHLETS) {
+            resident.insert(resident.end(), unit.begin(), unit.end());
+            continue;
+        }
+        if (pages.empty() || pages.back().size() + unit.size() > cen::MESHLET_PAGE_MESHLETS)
+            pages.emplace_back();
+        pages.back().insert(pages.back().end(), unit.begin(), unit.end());
+    }
+
+    std::vector<u32> meshletPages(data.meshlets.size(), MESHLET_PAGE_NONE);
+    for (u32 page = 0; page < pages.size(); page++) {
+        for (auto id : pages[page])
+            meshletPages[id] = firstPage + page;
+    }
+
+    for (u32 i = 0; auto& group : data.groups) {
+        auto& pageGroup = pageSet.groups.emplace_back();
+        for (u32 j = 0; j < group.outputCount; j++) {
+            if (meshletPages[group.firstOutput + j] != MESHLET_PAGE_NONE)
+                pageGroup.outputPage = meshletPages[group.firstOutput + j];
+        }
+        for (auto member : group.members) {
+            data.meshlets[member].parentGroup = firstGroup + i;
+            const u32 page = meshletPages[member];
+            if (page != MESHLET_PAGE_NONE && std::find(pageGroup.memberPages.begin(), pageGroup.memberPages.end(), page) == pageGroup.memberPages.end())
+                pageGroup.memberPages.push_back(page);
+        }
+        i++;
+    }
+    for (u32 i = 0; i < data.meshlets.size(); i++) {
+        data.meshlets[i].page = meshletPages[i];
+        data.meshlets[i].lodGroup = lodGroups[i] == MESHLET_GROUP_NONE ? MESHLET_GROUP_NONE : firstGroup + lodGroups[i];
+    }
+
+    std::vector<Meshlet> meshlets = {};
+    packMeshlets(data, vertices, resident, meshlets, residentVertices, residentIndices, residentPrimitives);
+
+    std::vector<Meshlet> pageMeshlets = {};
+    std::vector<Vertex> pageVertices = {};
+    std::vector<u32> pageIndices = {};
+    std::vector<u8> pagePrimitives = {};
+    for (auto& page : pages) {
+        pageMeshlets.clear();
+        pageVertices.clear();
+        pageIndices.clear();
+        pagePrimitives.clear();
+        packMeshlets(data, vertices, page, pageMeshlets, pageVertices, pageIndices, pagePrimitives);
+
+        pageSet.pages.push_back({
+            .dataOffset = static_cast<u32>(pageSet.data.size()),
+            .firstMeshlet = static_cast<u32>(firstMeshlet + meshlets.size()),
+            .meshletCount = static_cast<u32>(pageMeshlets.size()),
+            .vertexCount = static_cast<u32>(pageVertices.size()),
+            .indexCount = static_cast<u32>(pageIndices.size()),
+            .primitiveCount = static_cast<u32>(pagePrimitives.size())
+        });
+        auto append = [&pageSet] (const void* bytes, u64 size) {
+            pageSet.data.insert(pageSet.data.end(), static_cast<const u8*>(bytes), static_cast<const u8*>(bytes) + size);
+        };
+        append(pageMeshlets.data(), pageMeshlets.size() * sizeof(Meshlet));
+        append(pageVertices.data(), pageVertices.size() * sizeof(Vertex));
+        append(pageIndices.data(), pageIndices.size() * sizeof(u32));
+        append(pagePrimitives.data(), pagePrimitives.size() * sizeof(u8));
+
+        // until loaded the records only serve culling, their offsets are written by the streamer once the page is in a slot
+        for (auto meshlet : pageMeshlets) {
+            meshlet.vertexOffset = 0;
+            meshlet.indexOffset = 0;
+            meshlet.primitiveOffset = 0;
+            meshlets.push_back(meshlet);
+        }
+    }
+    data.meshlets = std::move(meshlets);
+}
+
 auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<Material> material) -> cen::Asset<Model> {
     auto hash = std::hash<std::filesystem::path>()(absolute(path));
     auto index = getAssetIndex(hash);
     if (index < 0)
         index = registerAsset(hash, path, "", AssetType::MODEL);
+    const ImportSettings importSettings = _importSettings;
 
     assert(index < _metadata.size());
     assert(_metadata[index].type == AssetType::MODEL);
@@ -247,8 +842,11 @@ auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<
     std::vector<ImageInfo> futures = {};
     std::vector<canta::ImageHandle> images = {};
     std::vector<MaterialInstance> materialInstances = {};
+    // base colour textures of alpha tested materials, empty for the rest
+    std::vector<std::filesystem::path> alphaMaskPaths = {};
     for (auto& assetMaterial : asset->materials) {
         auto materialInstance = material->instance();
+        std::filesystem::path albedoPath = {};
 
         if (assetMaterial.pbrData.baseColorTexture) {
             i32 textureIndex = assetMaterial.pbrData.baseColorTexture->textureIndex;
@@ -260,6 +858,7 @@ auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<
             if (imageIndex >= 0) {
                 auto& image = asset->images[imageIndex];
                 if (const auto* filePath = std::get_if<fastgltf::sources::URI>(&image.data); filePath) {
+                    albedoPath = path.parent_path() / filePath->uri.path();
                     futures.push_back({
                         .materialInstanceIndex = materialInstances.size(),
                         .materialParameter = "albedoIndex",
@@ -341,17 +940,26 @@ auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<
 
         if (assetMaterial.alphaMode != fastgltf::AlphaMode::Opaque && assetMaterial.alphaCutoff < 1)
             materialInstance.setTransparent(true);
+        materialInstance.setDoubleSided(assetMaterial.doubleSided);
 
+        alphaMaskPaths.push_back(materialInstance.isTransparent() ? albedoPath : std::filesystem::path{});
         materialInstances.push_back(std::move(materialInstance));
     }
 
-    if (materialInstances.empty())
+    if (materialInstances.empty()) {
         materialInstances.push_back(material->instance());
+        alphaMaskPaths.push_back({});
+    }
+    // masks are read on first use by a primitive so unused materials cost nothing
+    std::vector<std::optional<AlphaMask>> alphaMasks(alphaMaskPaths.size());
 
     std::vector<Vertex> vertices = {};
     std::vector<u32> indices = {};
     std::vector<Meshlet> meshlets = {};
     std::vector<u8> primitives = {};
+    // with geometry streaming enabled, meshlet geometry that isn't pinned resident is split into pages
+    const bool streaming = _engine->geometryStreamer().enabled();
+    cen::GeometryStreamer::PageSet pageSet = {};
 
     std::vector<Mesh> meshes = {};
 
@@ -451,42 +1059,42 @@ auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<
                 });
             }
 
-            const u32 coneWeight = 0.f;
-
-            u32 maxMeshlets = meshopt_buildMeshletsBound(meshIndices.size(), MAX_MESHLET_VERTICES, MAX_MESHLET_PRIMTIVES);
-            std::vector<meshopt_Meshlet> meshoptMeshlets(maxMeshlets);
-            std::vector<u32> meshletIndices(maxMeshlets * MAX_MESHLET_VERTICES);
-            std::vector<u8> meshletPrimitives(maxMeshlets * MAX_MESHLET_PRIMTIVES * 3);
-
-            u32 meshletCount = meshopt_buildMeshlets(meshoptMeshlets.data(), meshletIndices.data(), meshletPrimitives.data(), meshIndices.data(), meshIndices.size(), (f32*)meshVertices.data(), meshVertices.size(), sizeof(Vertex), MAX_MESHLET_VERTICES, MAX_MESHLET_PRIMTIVES, coneWeight);
-
-            auto& lastMeshlet = meshoptMeshlets[meshletCount - 1];
-            meshletIndices.resize(lastMeshlet.vertex_offset + lastMeshlet.vertex_count);
-            meshletPrimitives.resize(lastMeshlet.triangle_offset + ((lastMeshlet.triangle_count * 3 + 3) & ~3));
-            meshoptMeshlets.resize(meshletCount);
-
-            std::vector<Meshlet> meshMeshlets;
-            meshMeshlets.reserve(meshletCount);
-            for (auto& meshlet : meshoptMeshlets) {
-                auto bounds = meshopt_computeMeshletBounds(&meshletIndices[meshlet.vertex_offset], &meshletPrimitives[meshlet.triangle_offset], meshlet.triangle_count, (f32*)meshVertices.data(), meshVertices.size(), sizeof(Vertex));
+            optimiseGeometry(meshVertices, meshIndices, importSettings);
+
+            MeshletData meshletData = {
+                .size = _engine->meshletSize(),
+                .builder = importSettings.meshletBuilder
+            };
+            appendMeshlets(meshletData, meshIndices, meshVertices, importSettings.optimiseMeshlets);
+            if (importSettings.analyse)
+                analyseGeometry(meshVertices, meshIndices, meshletData.meshlets, meshletData.size, result.statistics);
+            buildClusterDag(meshletData, meshVertices, importSettings.optimiseMeshlets);
+
+            const u32 materialIndex = primitive.materialIndex.has_value() && materialInstances.size() > primitive.materialIndex.value() ? primitive.materialIndex.value() : 0;
+            if (importSettings.classifyAlpha && !alphaMaskPaths[materialIndex].empty()) {
+                if (!alphaMasks[materialIndex])
+                    alphaMasks[materialIndex] = loadAlphaMask(alphaMaskPaths[materialIndex]);
+                classifyAlpha(meshletData, meshVertices, *alphaMasks[materialIndex]);
+            }
 
-                ende::math::Vec3f center = { bounds.center[0], bounds.center[1], bounds.center[2] };
+            u32 meshPrimitiveCount = 0;
+            for (auto& meshlet : meshletData.meshlets)
+                meshPrimitiveCount += meshlet.primitiveCount;
+
+            if (streaming) {
+                splitPages(meshletData, meshVertices, firstMeshlet, pageSet, vertices, indices, primitives);
+            } else {
+                for (auto& meshlet : meshletData.meshlets) {
+                    meshlet.vertexOffset = firstVertex;
+                    meshlet.indexOffset += firstIndex;
+                    meshlet.primitiveOffset += firstPrimitive;
+                }
 
-                meshMeshlets.push_back({
-                    .vertexOffset = firstVertex,
-                    .indexOffset = meshlet.vertex_offset + firstIndex,
-                    .indexCount = meshlet.vertex_count,
-                    .primitiveOffset = meshlet.triangle_offset + firstPrimitive,
-                    .primitiveCount = meshlet.triangle_count,
-                    .center = center,
-                    .radius = bounds.radius
-                });
+                vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+                indices.insert(indices.end(), meshletData.indices.begin(), meshletData.indices.end());
+                primitives.insert(primitives.end(), meshletData.primitives.begin(), meshletData.primitives.end());
             }
-
-            vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
-            indices.insert(indices.end(), meshletIndices.begin(), meshletIndices.end());
-            primitives.insert(primitives.end(), meshletPrimitives.begin(), meshletPrimitives.end());
-            meshlets.insert(meshlets.end(), meshMeshlets.begin(), meshMeshlets.end());
+            meshlets.insert(meshlets.end(), meshletData.meshlets.begin(), meshletData.meshlets.end());
 
             MaterialInstance* materialInstance = &materialInstances.front();
             if (primitive.materialIndex.has_value() && materialInstances.size() > primitive.materialIndex.value())
@@ -499,11 +1107,13 @@ auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<
 
             meshes.push_back(Mesh{
                     .meshletOffset = firstMeshlet,
-                    .meshletCount = static_cast<u32>(meshMeshlets.size()),
+                    .meshletCount = static_cast<u32>(meshletData.meshlets.size()),
+                    .primitiveCount = meshPrimitiveCount,
                     .min = min,
                     .max = max,
                     .materialInstance = materialInstance,
-                    .alphaMapIndex = alphaMapIndex
+                    .alphaMapIndex = alphaMapIndex,
+                    .doubleSided = materialInstance->isDoubleSided()
             });
         }
     }
@@ -516,7 +1126,19 @@ auto cen::AssetManager::loadModel(const std::filesystem::path &path, cen::Asset<
         meshlet.indexOffset += indexOffset / sizeof(u32);
         meshlet.primitiveOffset += primitiveOffset / sizeof(u8);
     }
+    // page and group ids are reserved before upload so the meshlet records reference them from the start
+    auto [firstPage, firstGroup] = streaming ? _engine->geometryStreamer().reserve(pageSet.pages.size(), pageSet.groups.size()) : std::pair<u32, u32>{};
+    for (auto& meshlet : meshlets) {
+        if (meshlet.page != MESHLET_PAGE_NONE)
+            meshlet.page += firstPage;
+        if (meshlet.lodGroup != MESHLET_GROUP_NONE)
+            meshlet.lodGroup += firstGroup;
+        if (meshlet.parentGroup != MESHLET_GROUP_NONE)
+            meshlet.parentGroup += firstGroup;
+    }
     auto meshletOffset = _engine->uploadMeshletData(meshlets);
+    if (streaming)
+        _engine->geometryStreamer().addPages(pageSet, firstPage, firstGroup, meshletOffset / sizeof(Meshlet));
 
     for (auto& mesh : meshes) {
         mesh.meshletOffset += meshletOffset / sizeof(Meshlet);
@@ -620,9 +1242,10 @@ auto cen::AssetManager::loadMaterial(const std::filesystem::path &path) -> cen::
     auto materialDefinition = macroise(loadMaterialProperty(document["materialDefinition"]));
     auto materialLoad = macroise(removeComments(loadMaterialProperty(document["materialLoad"])));
 
-    auto material = Material::create({
-        .engine = _engine,
-        .lit = _engine->pipelineManager().getPipeline(_rootPath / pipelinePath, std::to_array({
+    // materials load on the thread pool so the pipeline manager is only used under the engine's pipeline lock
+    auto litPipeline = [&] {
+        std::unique_lock lock(_engine->pipelineMutex());
+        return _engine->pipelineManager().getPipeline(_rootPath / pipelinePath, std::to_array({
             canta::Macro{
                 .name = "materialParameters",
                 .value = materialParameters
@@ -639,7 +1262,11 @@ auto cen::AssetManager::loadMaterial(const std::filesystem::path &path) -> cen::
                 .name = "materialEval",
                 .value = macroise(removeComments(loadMaterialProperty(document["lit"])))
             },
-        }))
+        }));
+    }();
+    auto material = Material::create({
+        .engine = _engine,
+        .lit = litPipeline
     });
 
 
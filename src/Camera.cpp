@@ -85,9 +85,12 @@ auto cen::Camera::gpuCamera() const -> GPUCamera {
     for (u32 i = 0; i < 8; i++)
         frustum.corners[i] = corners[i];
 
+    const auto viewProjection = this->viewProjection();
     return {
         .projection = projection(),
         .view = view(),
+        .viewProjection = viewProjection,
+        .inverseViewProjection = viewProjection.inverse(),
         .position = _position,
         .near = _near,
         .far = _far,
@@ -106,7 +109,7 @@ auto cen::Camera::frustumCorners() const -> std::array<ende::math::Vec4f, 8> {
         const auto pt = inverseViewProjection.transform(ende::math::Vec4f{
             offsets[i].x(),
             offsets[i].y(),
-            i > 4 ? 0.f : 1.f,
+            i > 3 ? 0.f : 1.f,
             1
         });
         corners[i] = pt / pt.w();
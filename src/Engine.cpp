@@ -1,5 +1,6 @@
 #include "../include/Cen/Engine.h"
 #include <stb_image_write.h>
+#include <algorithm>
 
 auto cen::Engine::create(CreateInfo info) -> std::unique_ptr<Engine> {
     auto engine = std::make_unique<Engine>();
@@ -10,10 +11,23 @@ auto cen::Engine::create(CreateInfo info) -> std::unique_ptr<Engine> {
         .instanceExtensions = info.window->requiredExtensions(),
     }).value();
     engine->_threadPool = std::make_unique<ende::thread::ThreadPool>(info.threadCount);
+
+    engine->_meshletSize = info.meshletSize;
+    if (std::find(std::begin(MESHLET_SIZES), std::end(MESHLET_SIZES), info.meshletSize) == std::end(MESHLET_SIZES)) {
+        std::printf("unsupported meshlet size %d/%d, falling back to %d/%d\n", info.meshletSize.vertices, info.meshletSize.primitives, MESHLET_SIZES[0].vertices, MESHLET_SIZES[0].primitives);
+        engine->_meshletSize = MESHLET_SIZES[0];
+    }
     engine->_pipelineManager = canta::PipelineManager::create({
         .device = engine->device(),
         .rootPath = info.assetPath / "shaders"
     });
+    auto shaderCachePath = info.shaderCachePath.empty() ? info.assetPath / "shader_cache" : info.shaderCachePath;
+    engine->_shaderCache = ShaderCache::create({
+        .engine = engine.get(),
+        .rootPath = info.assetPath / "shaders",
+        .cachePath = info.shaderCacheEnabled ? shaderCachePath : std::filesystem::path{},
+        .includePaths = { std::filesystem::path(CEN_CANTA_SRC_DIR) }
+    });
     engine->_uploadBuffer = canta::UploadBuffer::create({
         .device = engine->device(),
         .size = 1 << 24
@@ -23,18 +37,30 @@ auto cen::Engine::create(CreateInfo info) -> std::unique_ptr<Engine> {
         .rootPath = std::filesystem::path(CEN_SRC_DIR) / "res"
     });
 
+    engine->_geometryStreamer = GeometryStreamer::create({
+        .engine = engine.get(),
+        .budget = info.geometryBudget,
+        // pages are split for the meshlet size so the page file is keyed by it
+        .pagePath = std::filesystem::temp_directory_path() / std::format("cen_geometry_pages_{}_{}.bin", engine->_meshletSize.vertices, engine->_meshletSize.primitives)
+    });
+    // the streamer's page slots take the start of the geometry buffers and resident geometry is uploaded after them
+    const u32 pageSlotCount = engine->_geometryStreamer.slotCount();
+    engine->_vertexOffset = pageSlotCount * engine->_geometryStreamer.slotVertexCount() * sizeof(Vertex);
+    engine->_indexOffset = pageSlotCount * engine->_geometryStreamer.slotIndexCount() * sizeof(u32);
+    engine->_primitiveOffset = pageSlotCount * engine->_geometryStreamer.slotPrimitiveCount() * sizeof(u8);
+
     engine->_vertexBuffer = engine->device()->createBuffer({
-        .size = 1 << 16,
+        .size = (1 << 16) + engine->_vertexOffset,
         .usage = canta::BufferUsage::STORAGE,
         .name = "vertex_buffer"
     });
     engine->_indexBuffer = engine->device()->createBuffer({
-        .size = 1 << 16,
+        .size = (1 << 16) + engine->_indexOffset,
         .usage = canta::BufferUsage::STORAGE,
         .name = "index_buffer"
     });
     engine->_primitiveBuffer = engine->device()->createBuffer({
-        .size = 1 << 16,
+        .size = (1 << 16) + engine->_primitiveOffset,
         .usage = canta::BufferUsage::STORAGE,
         .name = "primitive_buffer"
     });
@@ -51,12 +77,27 @@ auto cen::Engine::create(CreateInfo info) -> std::unique_ptr<Engine> {
 
 void cen::Engine::gc() {
     assetManager().uploadMaterials();
-    uploadBuffer().clearSubmitted();
-    uploadBuffer().flushStagedData();
-    pipelineManager().reloadAll();
+    {
+        std::unique_lock lock(_mutex);
+        uploadBuffer().clearSubmitted();
+        uploadBuffer().flushStagedData();
+    }
+    {
+        std::unique_lock lock(_pipelineMutex);
+        pipelineManager().reloadAll();
+    }
     device()->gc();
 }
 
+auto cen::Engine::getPipeline(const canta::Pipeline::CreateInfo& info) -> canta::PipelineHandle {
+    // shaders from the cache aren't reloaded so neither are their pipelines, which lets them skip the pipeline manager
+    // and be created in parallel
+    if (shaderCache().enabled())
+        return device()->createPipeline(info);
+    std::unique_lock lock(_pipelineMutex);
+    return pipelineManager().getPipeline(info);
+}
+
 auto cen::Engine::setMeshShadingEnabled(bool enabled) -> bool {
     _meshShadingEnabled = _device->meshShadersEnabled() && enabled;
     return _meshShadingEnabled;
@@ -158,6 +199,15 @@ auto cen::Engine::uploadMeshletData(std::span<const Meshlet> data) -> u32 {
     return currentOffset;
 }
 
+void cen::Engine::uploadPageData(std::span<const Vertex> vertices, u32 vertexOffset, std::span<const u32> indices, u32 indexOffset, std::span<const u8> primitives, u32 primitiveOffset, std::span<const Meshlet> meshlets, u32 meshletOffset) {
+    std::unique_lock lock(_mutex);
+    uploadBuffer().upload(_vertexBuffer, vertices, vertexOffset);
+    uploadBuffer().upload(_indexBuffer, indices, indexOffset);
+    uploadBuffer().upload(_primitiveBuffer, primitives, primitiveOffset);
+    uploadBuffer().upload(_meshletBuffer, meshlets, meshletOffset);
+    uploadBuffer().flushStagedData().wait();
+}
+
 auto cen::Engine::saveImageToDisk(canta::ImageHandle image, const std::filesystem::path &path, canta::ImageLayout srcLayout, bool tonemap) -> bool {
     auto tmpBuffer = _device->createBuffer({
         .size = image->size(),
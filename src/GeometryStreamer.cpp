@@ -0,0 +1,313 @@
+#include <Cen/GeometryStreamer.h>
+#include <Cen/Engine.h>
+#include <Canta/Buffer.h>
+#include <cstring>
+
+namespace {
+
+    // pages being read and uploaded on the thread pool at once
+    constexpr u32 MAX_PAGE_LOADS = 16;
+
+    auto groupFlags(const cen::GeometryStreamer::Group& group, std::span<const u32> pageSlots) -> u32 {
+        u32 flags = 0;
+        if (group.outputPage == MESHLET_PAGE_NONE || pageSlots[group.outputPage] != MESHLET_PAGE_NONE)
+            flags |= MESHLET_GROUP_OUTPUTS_RESIDENT;
+        bool membersResident = true;
+        for (auto page : group.memberPages)
+            membersResident = membersResident && pageSlots[page] != MESHLET_PAGE_NONE;
+        if (membersResident)
+            flags |= MESHLET_GROUP_MEMBERS_RESIDENT;
+        return flags;
+    }
+
+}
+
+auto cen::GeometryStreamer::slotVertexCount() const -> u32 {
+    return MESHLET_PAGE_MESHLETS * _engine->meshletSize().vertices;
+}
+
+auto cen::GeometryStreamer::slotIndexCount() const -> u32 {
+    return MESHLET_PAGE_MESHLETS * _engine->meshletSize().vertices;
+}
+
+auto cen::GeometryStreamer::slotPrimitiveCount() const -> u32 {
+    return MESHLET_PAGE_MESHLETS * _engine->meshletSize().primitives * 3;
+}
+
+auto cen::GeometryStreamer::slotCountForBudget(u64 budget) const -> u32 {
+    const u64 slotSize = slotVertexCount() * sizeof(Vertex) + slotIndexCount() * sizeof(u32) + slotPrimitiveCount() * sizeof(u8);
+    return budget / slotSize;
+}
+
+auto cen::GeometryStreamer::create(cen::GeometryStreamer::CreateInfo info) -> GeometryStreamer {
+    GeometryStreamer streamer = {};
+
+    streamer._engine = info.engine;
+    streamer._mutex = std::make_unique<std::mutex>();
+    streamer._slotCount = streamer.slotCountForBudget(info.budget);
+    if (streamer._slotCount == 0)
+        return streamer;
+
+    streamer._pagePath = info.pagePath;
+    streamer._pageFile = std::ofstream(info.pagePath, std::ios::binary | std::ios::trunc);
+
+    streamer._slots.resize(streamer._slotCount);
+    for (u32 slot = streamer._slotCount; slot-- > 0;)
+        streamer._freeSlots.push_back(slot);
+
+    for (u32 i = 0; auto& buffer : streamer._residencyBuffers) {
+        buffer = info.engine->device()->createBuffer({
+            .size = 1 << 16,
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("geometry_residency_buffer: {}", i++)
+        });
+    }
+    for (u32 i = 0; auto& buffer : streamer._feedbackBuffers) {
+        buffer = info.engine->device()->createBuffer({
+            .size = static_cast<u32>((MAX_PAGE_REQUESTS + streamer._slotCount) * sizeof(u32)),
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::READBACK,
+            .persistentlyMapped = true,
+            .name = std::format("geometry_feedback_buffer: {}", i++)
+        });
+        auto feedback = static_cast<u32*>(buffer->mapped().address());
+        std::memset(feedback, 0xFF, MAX_PAGE_REQUESTS * sizeof(u32));
+        std::memset(feedback + MAX_PAGE_REQUESTS, 0, streamer._slotCount * sizeof(u32));
+    }
+
+    return streamer;
+}
+
+auto cen::GeometryStreamer::residentPages() const -> u32 {
+    u32 count = 0;
+    for (auto& slot : _slots)
+        count += slot.page != MESHLET_PAGE_NONE ? 1 : 0;
+    return count;
+}
+
+auto cen::GeometryStreamer::reserve(u32 pageCount, u32 groupCount) -> std::pair<u32, u32> {
+    std::unique_lock lock(*_mutex);
+    u32 firstPage = _pages.size();
+    u32 firstGroup = _groups.size();
+    _pages.resize(firstPage + pageCount);
+    _pageSlots.resize(firstPage + pageCount, MESHLET_PAGE_NONE);
+    _groups.resize(firstGroup + groupCount);
+    _groupFlags.resize(firstGroup + groupCount, 0);
+    return { firstPage, firstGroup };
+}
+
+void cen::GeometryStreamer::addPages(const cen::GeometryStreamer::PageSet& pageSet, u32 firstPage, u32 firstGroup, u32 meshletOffset) {
+    std::unique_lock lock(*_mutex);
+
+    // page and group ids in the meshlet records are made global before they are written out
+    std::vector<u8> data = pageSet.data;
+    for (auto& page : pageSet.pages) {
+        for (u32 i = 0; i < page.meshletCount; i++) {
+            Meshlet meshlet = {};
+            std::memcpy(&meshlet, data.data() + page.dataOffset + i * sizeof(Meshlet), sizeof(Meshlet));
+            meshlet.page += firstPage;
+            if (meshlet.lodGroup != MESHLET_GROUP_NONE)
+                meshlet.lodGroup += firstGroup;
+            if (meshlet.parentGroup != MESHLET_GROUP_NONE)
+                meshlet.parentGroup += firstGroup;
+            std::memcpy(data.data() + page.dataOffset + i * sizeof(Meshlet), &meshlet, sizeof(Meshlet));
+        }
+    }
+    _pageFile.write(reinterpret_cast<const char*>(data.data()), data.size());
+    _pageFile.flush();
+
+    for (u32 i = 0; auto& page : pageSet.pages) {
+        _pages[firstPage + i++] = {
+            .fileOffset = _pageFileSize + page.dataOffset,
+            .firstMeshlet = meshletOffset + page.firstMeshlet,
+            .meshletCount = page.meshletCount,
+            .vertexCount = page.vertexCount,
+            .indexCount = page.indexCount,
+            .primitiveCount = page.primitiveCount
+        };
+    }
+    _pageFileSize += data.size();
+
+    for (u32 i = 0; auto& group : pageSet.groups) {
+        const u32 groupIndex = firstGroup + i++;
+        auto& globalGroup = _groups[groupIndex];
+        globalGroup.outputPage = group.outputPage == MESHLET_PAGE_NONE ? MESHLET_PAGE_NONE : group.outputPage + firstPage;
+        globalGroup.memberPages.clear();
+        for (auto page : group.memberPages)
+            globalGroup.memberPages.push_back(page + firstPage);
+
+        if (globalGroup.outputPage != MESHLET_PAGE_NONE)
+            _pages[globalGroup.outputPage].groups.push_back(groupIndex);
+        for (auto page : globalGroup.memberPages)
+            _pages[page].groups.push_back(groupIndex);
+        _groupFlags[groupIndex] = groupFlags(globalGroup, _pageSlots);
+    }
+}
+
+void cen::GeometryStreamer::update(u32 flyingIndex) {
+    if (!enabled())
+        return;
+    std::unique_lock lock(*_mutex);
+    _frame++;
+
+    // the frame that last used this index has finished so its feedback is complete
+    auto feedback = static_cast<u32*>(_feedbackBuffers[flyingIndex]->mapped().address());
+    u32* requests = feedback;
+    u32* slotUsage = feedback + MAX_PAGE_REQUESTS;
+    for (u32 slot = 0; slot < _slotCount; slot++) {
+        if (slotUsage[slot] != 0)
+            _slots[slot].lastUsed = _frame;
+    }
+
+    // loads wait for their upload to complete on the thread pool so finished pages can be drawn from this frame
+    for (auto it = _loads.begin(); it != _loads.end();) {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        _pages[it->page].loading = false;
+        if (it->result.get()) {
+            _pageSlots[it->page] = it->slot;
+            _slots[it->slot] = { .page = it->page, .lastUsed = _frame };
+            updateGroups(it->page);
+        } else {
+            _freeSlots.push_back(it->slot);
+        }
+        it = _loads.erase(it);
+    }
+
+    for (auto it = _retiredSlots.begin(); it != _retiredSlots.end();) {
+        if (it->second + canta::FRAMES_IN_FLIGHT < _frame) {
+            _freeSlots.push_back(it->first);
+            it = _retiredSlots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    u32 evictions = 0;
+    for (u32 i = 0; i < MAX_PAGE_REQUESTS && _loads.size() < MAX_PAGE_LOADS; i++) {
+        const u32 pageIndex = requests[i];
+        if (pageIndex >= _pages.size())
+            continue;
+        auto& page = _pages[pageIndex];
+        // a recently evicted page's meshlet records may still be read by a frame in flight
+        const bool recentlyEvicted = page.evictedFrame != 0 && page.evictedFrame + canta::FRAMES_IN_FLIGHT >= _frame;
+        if (page.loading || _pageSlots[pageIndex] != MESHLET_PAGE_NONE || recentlyEvicted)
+            continue;
+
+        if (_freeSlots.empty()) {
+            // evicted slots only free up once retired so the request is picked up again in a later frame
+            if (evictions++ >= MAX_PAGE_LOADS || !evictLeastRecentlyUsed())
+                break;
+            continue;
+        }
+        const u32 slot = _freeSlots.back();
+        _freeSlots.pop_back();
+
+        page.loading = true;
+        _loads.push_back({
+            .page = pageIndex,
+            .slot = slot,
+            .result = _engine->threadPool().addJob([this] (PageState page, u32 slot) {
+                return loadPage(page, slot);
+            }, page, slot)
+        });
+    }
+    std::memset(requests, 0xFF, MAX_PAGE_REQUESTS * sizeof(u32));
+    std::memset(slotUsage, 0, _slotCount * sizeof(u32));
+
+    const u32 residencySize = (_pageSlots.size() + _groupFlags.size()) * sizeof(u32);
+    if (_residencyBuffers[flyingIndex]->size() < residencySize) {
+        _residencyBuffers[flyingIndex] = _engine->device()->createBuffer({
+            .size = residencySize,
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("geometry_residency_buffer: {}", flyingIndex)
+        }, _residencyBuffers[flyingIndex]);
+    }
+    auto residency = static_cast<u32*>(_residencyBuffers[flyingIndex]->mapped().address());
+    std::memcpy(residency, _pageSlots.data(), _pageSlots.size() * sizeof(u32));
+    std::memcpy(residency + _pageSlots.size(), _groupFlags.data(), _groupFlags.size() * sizeof(u32));
+    _groupBufferOffsets[flyingIndex] = _pageSlots.size() * sizeof(u32);
+}
+
+auto cen::GeometryStreamer::pageBufferAddress(u32 flyingIndex) const -> u64 {
+    if (!enabled())
+        return 0;
+    return _residencyBuffers[flyingIndex]->address();
+}
+
+auto cen::GeometryStreamer::groupBufferAddress(u32 flyingIndex) const -> u64 {
+    if (!enabled())
+        return 0;
+    return _residencyBuffers[flyingIndex]->address() + _groupBufferOffsets[flyingIndex];
+}
+
+auto cen::GeometryStreamer::feedbackBufferAddress(u32 flyingIndex) const -> u64 {
+    if (!enabled())
+        return 0;
+    return _feedbackBuffers[flyingIndex]->address();
+}
+
+auto cen::GeometryStreamer::loadPage(PageState page, u32 slot) -> bool {
+    std::vector<Meshlet> meshlets(page.meshletCount);
+    std::vector<Vertex> vertices(page.vertexCount);
+    std::vector<u32> indices(page.indexCount);
+    std::vector<u8> primitives(page.primitiveCount);
+
+    std::ifstream file(_pagePath, std::ios::binary);
+    file.seekg(page.fileOffset);
+    file.read(reinterpret_cast<char*>(meshlets.data()), meshlets.size() * sizeof(Meshlet));
+    file.read(reinterpret_cast<char*>(vertices.data()), vertices.size() * sizeof(Vertex));
+    file.read(reinterpret_cast<char*>(indices.data()), indices.size() * sizeof(u32));
+    file.read(reinterpret_cast<char*>(primitives.data()), primitives.size() * sizeof(u8));
+    if (!file)
+        return false;
+
+    for (auto& meshlet : meshlets) {
+        meshlet.vertexOffset = slot * slotVertexCount();
+        meshlet.indexOffset += slot * slotIndexCount();
+        meshlet.primitiveOffset += slot * slotPrimitiveCount();
+    }
+
+    _engine->uploadPageData(
+        vertices, slot * slotVertexCount() * sizeof(Vertex),
+        indices, slot * slotIndexCount() * sizeof(u32),
+        primitives, slot * slotPrimitiveCount() * sizeof(u8),
+        meshlets, page.firstMeshlet * sizeof(Meshlet));
+    return true;
+}
+
+void cen::GeometryStreamer::updateGroups(u32 pageIndex) {
+    for (auto group : _pages[pageIndex].groups)
+        _groupFlags[group] = groupFlags(_groups[group], _pageSlots);
+}
+
+auto cen::GeometryStreamer::evictLeastRecentlyUsed() -> bool {
+    // pages drawn by frames whose feedback hasn't been read yet may look unused, so leave a frame in flight of margin
+    u32 victim = MESHLET_PAGE_NONE;
+    u64 oldest = _frame;
+    for (u32 slot = 0; slot < _slotCount; slot++) {
+        auto& state = _slots[slot];
+        if (state.page == MESHLET_PAGE_NONE || state.lastUsed + canta::FRAMES_IN_FLIGHT >= _frame)
+            continue;
+        if (state.lastUsed < oldest) {
+            oldest = state.lastUsed;
+            victim = slot;
+        }
+    }
+    if (victim == MESHLET_PAGE_NONE)
+        return false;
+
+    const u32 pageIndex = _slots[victim].page;
+    _pageSlots[pageIndex] = MESHLET_PAGE_NONE;
+    _pages[pageIndex].evictedFrame = _frame;
+    updateGroups(pageIndex);
+    _slots[victim].page = MESHLET_PAGE_NONE;
+    _retiredSlots.push_back({ victim, _frame });
+    return true;
+}
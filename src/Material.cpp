@@ -6,12 +6,14 @@ cen::MaterialInstance::MaterialInstance(cen::MaterialInstance &&rhs) noexcept {
     std::swap(_material, rhs._material);
     std::swap(_offset, rhs._offset);
     std::swap(_transparent, rhs._transparent);
+    std::swap(_doubleSided, rhs._doubleSided);
 }
 
 auto cen::MaterialInstance::operator=(cen::MaterialInstance &&rhs) noexcept -> MaterialInstance & {
     std::swap(_material, rhs._material);
     std::swap(_offset, rhs._offset);
     std::swap(_transparent, rhs._transparent);
+    std::swap(_doubleSided, rhs._doubleSided);
     return *this;
 }
 
@@ -1,19 +1,50 @@
 #include <Cen/Renderer.h>
 #include <Cen/Engine.h>
 #include <cstring>
+#include <limits>
 #include <Cen/ui/GuiWorkspace.h>
 
 #include <passes/MeshletDrawPass.h>
 #include <passes/MeshletsCullPass.h>
 #include <passes/DebugPasses.h>
 #include <passes/BloomPass.h>
+#include <passes/ExposurePass.h>
+#include <passes/LightCullingPass.h>
+#include <passes/SoftwareRasterPass.h>
 
 #include <stb_image_write.h>
 
+namespace {
+
+    // grow by at least half again so streaming in geometry doesn't resize the transient buffers every frame
+    auto growCapacity(u32 capacity, u32 required, u32 limit) -> u32 {
+        if (required <= capacity)
+            return capacity;
+        return std::min(std::max(required, capacity + capacity / 2), limit);
+    }
+
+    // the fused tonemap writes the swapchain image as a storage image. that needs storage usage and a format with
+    // mandatory storage support, srgb surface formats never have it
+    auto storageWritable(canta::ImageHandle image) -> bool {
+        if ((image->usage() & canta::ImageUsage::STORAGE) != canta::ImageUsage::STORAGE)
+            return false;
+        switch (image->format()) {
+            case canta::Format::RGBA8_UNORM:
+            case canta::Format::RGBA16_SFLOAT:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+}
+
 auto cen::Renderer::create(cen::Renderer::CreateInfo info) -> Renderer {
     Renderer renderer = {};
 
     renderer._engine = info.engine;
+    // meshlet size is fixed for the engine's lifetime so the mesh pipelines are only built for it
+    const auto meshletSize = info.engine->meshletSize();
     renderer._renderGraph = canta::RenderGraph::create({
         .device = info.engine->device(),
         .timingMode = canta::RenderGraph::TimingMode::PER_GROUP,
@@ -22,8 +53,8 @@ auto cen::Renderer::create(cen::Renderer::CreateInfo info) -> Renderer {
 
     renderer._globalData = {
         .maxMeshCount = 0,
-        .maxMeshletCount = MAX_MESHLET_INSTANCE,
-        .maxIndirectIndexCount = 10000000 * 3,
+        .maxMeshletCount = 1024,
+        .maxIndirectIndexCount = 1024 * meshletSize.primitives * 3,
         .screenSize = { 1920, 1080 }
     };
 
@@ -62,172 +93,528 @@ auto cen::Renderer::create(cen::Renderer::CreateInfo info) -> Renderer {
             .name = std::format("feedback_buffer_{}", i++)
         });
     }
+    for (u32 i = 0; auto& buffer : renderer._clusterBuffers) {
+        buffer = info.engine->device()->createBuffer({
+            .size = sizeof(LightCluster) * CLUSTER_COUNT,
+            .usage = canta::BufferUsage::STORAGE,
+            .name = std::format("light_cluster_buffer_{}", i++)
+        });
+    }
+    for (u32 i = 0; auto& buffer : renderer._clusterLightIndexBuffers) {
+        buffer = info.engine->device()->createBuffer({
+            .size = static_cast<u32>(sizeof(u32) * CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER),
+            .usage = canta::BufferUsage::STORAGE,
+            .name = std::format("cluster_light_index_buffer_{}", i++)
+        });
+    }
+    renderer._exposureBuffer = info.engine->device()->createBuffer({
+        .size = sizeof(ExposureData),
+        .usage = canta::BufferUsage::STORAGE,
+        .name = "exposure_buffer"
+    });
+    // seeded with the key value so the first adapted frame starts at an exposure of 1 rather than whatever the memory held
+    const ExposureData initialExposure = {
+        .exposure = 1,
+        .averageLuminance = renderer._renderSettings.exposureKeyValue
+    };
+    info.engine->uploadBuffer().upload(renderer._exposureBuffer, std::span<const ExposureData>(&initialExposure, 1), 0);
+    info.engine->uploadBuffer().flushStagedData().wait();
+    renderer._lastFrameTime = std::chrono::high_resolution_clock::now();
 
-    renderer._cullMeshesPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "cull_meshes.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "cull_meshes"
-    });
-    renderer._writeMeshletCullCommandPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "write_mesh_command.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "write_mesh_command"
-    });
-    renderer._cullMeshletsPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "cull_meshlets.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "cull_meshlets"
+    const auto pipelineStart = std::chrono::high_resolution_clock::now();
+    // the culling statistics counters can be compiled out of the culling shaders with CEN_CULLING_STATS
+    std::vector<canta::Macro> cullingMacros = {};
+#ifdef CEN_CULLING_STATS
+    cullingMacros.push_back(canta::Macro{ "CULLING_STATS", std::to_string(true) });
+#endif
+    std::vector<canta::Macro> taskMacros = cullingMacros;
+    taskMacros.push_back(canta::Macro{ "TASK_WORKGROUP_SIZE", std::to_string(64) });
+
+    // every pipeline is compiled on the thread pool at once and waited on before the renderer is returned
+    std::vector<std::future<bool>> pipelineJobs = {};
+    const auto compilePipeline = [&] (canta::PipelineHandle& pipeline, std::function<canta::PipelineHandle()> create) {
+        pipelineJobs.push_back(info.engine->threadPool().addJob([&pipeline, create] {
+            pipeline = create();
+            return true;
+        }));
+    };
+
+    compilePipeline(renderer._cullMeshesPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "cull_meshes.comp",
+                .macros = cullingMacros,
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "cull_meshes"
+        });
+    });
+    compilePipeline(renderer._expandMeshesPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "expand_meshes.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "expand_meshes"
+        });
+    });
+    compilePipeline(renderer._expandMeshesMultiViewPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "expand_meshes.comp",
+                .macros = {
+                    canta::Macro{ "MULTI_VIEW", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "expand_meshes_multi_view"
+        });
+    });
+    compilePipeline(renderer._cullMeshletsPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "cull_meshlets.comp",
+                .macros = cullingMacros,
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "cull_meshlets"
+        });
+    });
+    compilePipeline(renderer._cullMeshesMultiViewPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "cull_meshes_multi_view.comp",
+                .macros = cullingMacros,
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "cull_meshes_multi_view"
+        });
     });
-    renderer._writeMeshletDrawCommandPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "write_meshlet_command.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "write_meshlet_command"
-    });
-    renderer._drawMeshletsPipelineMeshPath = info.engine->pipelineManager().getPipeline({
-        .fragment = { .module = info.engine->pipelineManager().getShader({
-            .path = "visibility_buffer/visibility.frag",
-            .stage = canta::ShaderStage::FRAGMENT
-        })},
-        .mesh = { .module = info.engine->pipelineManager().getShader({
-            .path = "default.mesh",
-            .macros = {
-                canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
-                canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(cen::MAX_MESHLET_VERTICES) },
-                canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(cen::MAX_MESHLET_PRIMTIVES) }
+    compilePipeline(renderer._cullMeshletsMultiViewPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "cull_meshlets_multi_view.comp",
+                .macros = cullingMacros,
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "cull_meshlets_multi_view"
+        });
+    });
+    compilePipeline(renderer._drawMeshletsPipelineMeshPath, [&] {
+        return info.engine->getPipeline({
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/visibility.frag",
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .task = { .module = info.engine->shaderCache().getShader({
+                .path = "default.task",
+                .macros = taskMacros,
+                .stage = canta::ShaderStage::TASK
+            })},
+            .mesh = { .module = info.engine->shaderCache().getShader({
+                .path = "default.mesh",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) },
+                    canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(meshletSize.primitives) },
+                    canta::Macro{ "TASK_SHADER", std::to_string(true) },
+                    canta::Macro{ "TASK_WORKGROUP_SIZE", std::to_string(64) }
+                },
+                .stage = canta::ShaderStage::MESH
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
             },
-            .stage = canta::ShaderStage::MESH
-        })},
-        .rasterState = {
-            .cullMode = canta::CullMode::NONE
-        },
-        .depthState = {
-            .test = true,
-            .write = true,
-            .compareOp = canta::CompareOp::GEQUAL
-        },
-        .colourFormats = { canta::Format::R32_UINT },
-        .depthFormat = canta::Format::D32_SFLOAT,
-        .name = "draw_meshlets_mesh_path"
-    });
-    renderer._drawMeshletsPipelineMeshAlphaPath = info.engine->pipelineManager().getPipeline({
-        .fragment = { .module = info.engine->pipelineManager().getShader({
-            .path = "visibility_buffer/visibility.frag",
-            .macros = {
-                canta::Macro{ "ALPHA_TEST", std::to_string(true) }
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
             },
-            .stage = canta::ShaderStage::FRAGMENT
-        })},
-        .mesh = { .module = info.engine->pipelineManager().getShader({
-            .path = "default.mesh",
-            .macros = {
-                canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
-                canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(cen::MAX_MESHLET_VERTICES) },
-                canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(cen::MAX_MESHLET_PRIMTIVES) }
+            .colourFormats = { canta::Format::R32_UINT },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "draw_meshlets_mesh_path"
+        });
+    });
+    compilePipeline(renderer._drawMeshletsPipelineMeshAlphaPath, [&] {
+        return info.engine->getPipeline({
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/visibility.frag",
+                .macros = {
+                    canta::Macro{ "ALPHA_TEST", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .task = { .module = info.engine->shaderCache().getShader({
+                .path = "default.task",
+                .macros = taskMacros,
+                .stage = canta::ShaderStage::TASK
+            })},
+            .mesh = { .module = info.engine->shaderCache().getShader({
+                .path = "default.mesh",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) },
+                    canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(meshletSize.primitives) },
+                    canta::Macro{ "TASK_SHADER", std::to_string(true) },
+                    canta::Macro{ "TASK_WORKGROUP_SIZE", std::to_string(64) }
+                },
+                .stage = canta::ShaderStage::MESH
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
             },
-            .stage = canta::ShaderStage::MESH
-        })},
-        .rasterState = {
-            .cullMode = canta::CullMode::NONE
-        },
-        .depthState = {
-            .test = true,
-            .write = true,
-            .compareOp = canta::CompareOp::GEQUAL
-        },
-        .colourFormats = { canta::Format::R32_UINT },
-        .depthFormat = canta::Format::D32_SFLOAT,
-        .name = "draw_meshlets_alpha_mesh_path"
-    });
-    renderer._writePrimitivesPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "output_indirect.comp",
-            .macros = {
-                canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
-                canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(cen::MAX_MESHLET_VERTICES) },
-                canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(cen::MAX_MESHLET_PRIMTIVES) }
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
             },
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "write_primtives"
-    });
-    renderer._drawMeshletsPipelineVertexPath = info.engine->pipelineManager().getPipeline({
-        .vertex = { .module = info.engine->pipelineManager().getShader({
-            .path = "default.vert",
-            .stage = canta::ShaderStage::VERTEX
-        })},
-        .fragment = { .module = info.engine->pipelineManager().getShader({
-            .path = "visibility_buffer/visibility.frag",
-            .stage = canta::ShaderStage::FRAGMENT
-        })},
-        .rasterState = {
-            .cullMode = canta::CullMode::NONE
-        },
-        .depthState = {
-            .test = true,
-            .write = true,
-            .compareOp = canta::CompareOp::GEQUAL
-        },
-        .colourFormats = { canta::Format::R32_UINT },
-        .depthFormat = canta::Format::D32_SFLOAT,
-        .name = "draw_meshlets_vertex_path"
-    });
-    renderer._tonemapPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "tonemap.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "tonemap"
-    });
-    renderer._bloomDownsamplePipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "bloom/downsample.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "bloom_downsample"
-    });
-    renderer._bloomUpsamplePipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "bloom/upsample.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "bloom_upsample"
-    });
-    renderer._bloomCompositePipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "bloom/composite.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "bloom_composite"
-    });
-    renderer._skyPipeline = info.engine->pipelineManager().getPipeline({
-        .compute = { .module = info.engine->pipelineManager().getShader({
-            .path = "sky.comp",
-            .stage = canta::ShaderStage::COMPUTE
-        })},
-        .name = "sky"
+            .colourFormats = { canta::Format::R32_UINT },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "draw_meshlets_alpha_mesh_path"
+        });
+    });
+    compilePipeline(renderer._writePrimitivesPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "output_indirect.comp",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) },
+                    canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(meshletSize.primitives) }
+                },
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "write_primtives"
+        });
+    });
+    compilePipeline(renderer._drawMeshletsPipelineVertexPath, [&] {
+        return info.engine->getPipeline({
+            .vertex = { .module = info.engine->shaderCache().getShader({
+                .path = "default.vert",
+                .stage = canta::ShaderStage::VERTEX
+            })},
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/visibility.frag",
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
+            },
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
+            },
+            .colourFormats = { canta::Format::R32_UINT },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "draw_meshlets_vertex_path"
+        });
+    });
+    compilePipeline(renderer._softwareRasterisePipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/software_rasterise.comp",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) }
+                },
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "software_rasterise"
+        });
+    });
+    compilePipeline(renderer._softwareResolvePipeline, [&] {
+        return info.engine->getPipeline({
+            .vertex = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/software_resolve.vert",
+                .stage = canta::ShaderStage::VERTEX
+            })},
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/software_resolve.frag",
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
+            },
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
+            },
+            .colourFormats = { canta::Format::R32_UINT },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "software_resolve"
+        });
+    });
+    compilePipeline(renderer._drawShadowPipelineMeshPath, [&] {
+        return info.engine->getPipeline({
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/visibility.frag",
+                .macros = {
+                    canta::Macro{ "DEPTH_ONLY", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .mesh = { .module = info.engine->shaderCache().getShader({
+                .path = "default.mesh",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) },
+                    canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(meshletSize.primitives) },
+                    canta::Macro{ "DEPTH_ONLY", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::MESH
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
+            },
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
+            },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "draw_shadow_mesh_path"
+        });
+    });
+    compilePipeline(renderer._drawShadowPipelineMeshAlphaPath, [&] {
+        return info.engine->getPipeline({
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/visibility.frag",
+                .macros = {
+                    canta::Macro{ "ALPHA_TEST", std::to_string(true) },
+                    canta::Macro{ "DEPTH_ONLY", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .mesh = { .module = info.engine->shaderCache().getShader({
+                .path = "default.mesh",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) },
+                    canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(meshletSize.primitives) },
+                    canta::Macro{ "DEPTH_ONLY", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::MESH
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
+            },
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
+            },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "draw_shadow_alpha_mesh_path"
+        });
+    });
+    compilePipeline(renderer._writeShadowPrimitivesPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "output_indirect.comp",
+                .macros = {
+                    canta::Macro{ "WORKGROUP_SIZE_X", std::to_string(64) },
+                    canta::Macro{ "MAX_MESHLET_VERTICES", std::to_string(meshletSize.vertices) },
+                    canta::Macro{ "MAX_MESHLET_PRIMTIVES", std::to_string(meshletSize.primitives) },
+                    canta::Macro{ "DEPTH_ONLY", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "write_shadow_primtives"
+        });
+    });
+    compilePipeline(renderer._drawShadowPipelineVertexPath, [&] {
+        return info.engine->getPipeline({
+            .vertex = { .module = info.engine->shaderCache().getShader({
+                .path = "default.vert",
+                .stage = canta::ShaderStage::VERTEX
+            })},
+            .fragment = { .module = info.engine->shaderCache().getShader({
+                .path = "visibility_buffer/visibility.frag",
+                .macros = {
+                    canta::Macro{ "DEPTH_ONLY", std::to_string(true) }
+                },
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE
+            },
+            .depthState = {
+                .test = true,
+                .write = true,
+                .compareOp = canta::CompareOp::GEQUAL
+            },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "draw_shadow_vertex_path"
+        });
+    });
+    compilePipeline(renderer._cullLightsPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "light/cull_lights.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "cull_lights"
+        });
+    });
+    compilePipeline(renderer._tonemapPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "tonemap.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "tonemap"
+        });
+    });
+    compilePipeline(renderer._bloomDownsamplePipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "bloom/downsample.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "bloom_downsample"
+        });
+    });
+    compilePipeline(renderer._bloomUpsamplePipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "bloom/upsample.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "bloom_upsample"
+        });
+    });
+    compilePipeline(renderer._exposureHistogramPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "exposure/histogram.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "exposure_histogram"
+        });
+    });
+    compilePipeline(renderer._exposureAveragePipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "exposure/average.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "exposure_average"
+        });
+    });
+    compilePipeline(renderer._skyPipeline, [&] {
+        return info.engine->getPipeline({
+            .compute = { .module = info.engine->shaderCache().getShader({
+                .path = "sky.comp",
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = "sky"
+        });
     });
 
+    // pipelines used only by debug views are queued behind the rest without being waited on
+    renderer.asyncComputePipeline("debug/meshletId.comp", "debug_meshletId");
+    renderer.asyncComputePipeline("debug/primitiveId.comp", "debug_primitiveId");
+    renderer.asyncComputePipeline("debug/meshId.comp", "debug_meshId");
+    renderer.asyncComputePipeline("debug/materialId.comp", "debug_materialId");
+    renderer.asyncComputePipeline("debug/wireframe_solid.comp", "debug_wireframe");
+    renderer.asyncComputePipeline("util/mouse_pick.comp", "util_mouse_pick");
+    renderer.debugFrustumPipeline();
+
+    for (auto& job : pipelineJobs)
+        job.wait();
+
+    renderer._pipelineCreateMilliseconds = std::chrono::duration<f64, std::milli>(std::chrono::high_resolution_clock::now() - pipelineStart).count();
+
     return renderer;
 }
 
+cen::Renderer::~Renderer() {
+    for (auto& [key, pipeline] : _asyncPipelines)
+        pipeline.wait();
+}
+
+auto cen::Renderer::asyncPipeline(const std::string& key, std::function<canta::PipelineHandle()> create) -> canta::PipelineHandle {
+    auto it = _asyncPipelines.find(key);
+    if (it == _asyncPipelines.end())
+        it = _asyncPipelines.insert(std::make_pair(key, _engine->threadPool().addJob(std::move(create)).share())).first;
+    if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return {};
+    return it->second.get();
+}
+
+auto cen::Renderer::asyncComputePipeline(const std::filesystem::path& path, std::string_view name) -> canta::PipelineHandle {
+    return asyncPipeline(std::string(name), [engine = _engine, path, name] {
+        return engine->getPipeline({
+            .compute = { .module = engine->shaderCache().getShader({
+                .path = path,
+                .stage = canta::ShaderStage::COMPUTE
+            })},
+            .name = name
+        });
+    });
+}
+
+auto cen::Renderer::debugFrustumPipeline() -> canta::PipelineHandle {
+    // line width is baked into the pipeline so each width used gets its own. widths are snapped to half pixel steps
+    // in a small range so dragging the setting only ever creates a handful of pipelines
+    const f32 lineWidth = std::clamp(std::round(_renderSettings.debugLineWidth * 2) / 2, 0.5f, 8.f);
+    return asyncPipeline(std::format("debug_frustum:{}", lineWidth), [engine = _engine, lineWidth] {
+        return engine->getPipeline({
+            .vertex = { .module = engine->shaderCache().getShader({
+                .path = "debug/frustum.vert",
+                .stage = canta::ShaderStage::VERTEX
+            })},
+            .fragment = { .module = engine->shaderCache().getShader({
+                .path = "debug/solid_colour.frag",
+                .stage = canta::ShaderStage::FRAGMENT
+            })},
+            .rasterState = {
+                .cullMode = canta::CullMode::NONE,
+                .polygonMode = canta::PolygonMode::LINE,
+                .lineWidth = lineWidth
+            },
+            .depthState = {
+                .test = true,
+                .write = false,
+                .compareOp = canta::CompareOp::GEQUAL
+            },
+            .colourFormats = { canta::Format::RGBA32_SFLOAT },
+            .depthFormat = canta::Format::D32_SFLOAT,
+            .name = "debug_frustum"
+        });
+    });
+}
+
 auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* swapchain, ui::GuiWorkspace* guiWorkspace) -> canta::ImageHandle {
     auto flyingIndex = _engine->device()->flyingIndex();
     _renderGraph.reset();
 
+    auto frameTime = std::chrono::high_resolution_clock::now();
+    f32 dt = std::chrono::duration<f32>(frameTime - _lastFrameTime).count();
+    _lastFrameTime = frameTime;
+
+    // every mesh is culled at most once per view so the scene totals bound the instances and generated indices
+    // of a single view. capacities only grow and must be settled before any buffer is added to the graph.
+    _globalData.maxMeshletCount = growCapacity(_globalData.maxMeshletCount, sceneInfo.meshletCount, MESHLET_INSTANCE_LIMIT);
+    _globalData.maxIndirectIndexCount = growCapacity(_globalData.maxIndirectIndexCount,
+        static_cast<u32>(std::min<u64>(static_cast<u64>(sceneInfo.primitiveCount) * 3, std::numeric_limits<u32>::max())),
+        std::numeric_limits<u32>::max() / sizeof(u32) - 1);
+
+    _globalData.screenSize = { swapchain->width(), swapchain->height() };
+
+    // the frame that last used this index has finished, so its page requests can be served before this one is recorded
+    _engine->geometryStreamer().update(flyingIndex);
+
     bool debugEnabled = _renderSettings.debugMeshletId ||
                         _renderSettings.debugPrimitiveId ||
                         _renderSettings.debugMeshId ||
                         _renderSettings.debugWireframe;
-
     auto swapchainImage = swapchain->acquire();
+    // the ui samples the backbuffer in the viewport window so it must still be written when the gui is active. the
+    // blit from the backbuffer is kept for swapchains the tonemap can't write to
+    bool fusedOutput = !debugEnabled && !guiWorkspace && _renderSettings.screenshotImage.id < 0 && storageWritable(swapchainImage.value());
     auto swapchainResource = _renderGraph.addImage({
         .handle = swapchainImage.value(),
         .name = "swapchain_image"
@@ -269,6 +656,10 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
         .handle = sceneInfo.cameraBuffer,
         .name = "camera_buffer"
     });
+    auto cullingViewResource = _renderGraph.addBuffer({
+        .handle = sceneInfo.cullingViewBuffer,
+        .name = "culling_view_buffer"
+    });
     auto transformsResource = _renderGraph.addBuffer({
         .handle = sceneInfo.transformBuffer,
         .name = "transforms_buffer"
@@ -295,23 +686,42 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
         .name = "backbuffer"
     });
 
+    // the software path bins meshlets in the compute culling pass so it replaces task shader culling while enabled
+    const bool softwareRaster = _renderSettings.softwareRaster;
+    const bool taskShading = _engine->meshShadingEnabled() && !softwareRaster;
+    std::optional<canta::BufferIndex> softwareMeshletResource = {};
+    canta::BufferIndex softwareCommandResource = {};
+    if (softwareRaster) {
+        softwareMeshletResource = _renderGraph.addBuffer({
+            .size = passes::meshletInstanceBufferSize(_globalData.maxMeshletCount),
+            .name = "software_meshlet_buffer"
+        });
+        softwareCommandResource = _renderGraph.addBuffer({
+            .size = sizeof(DispatchIndirectCommand),
+            .name = "software_meshlet_command_buffer"
+        });
+    }
+
     passes::cullMeshlets(_renderGraph, {
         .globalBuffer = globalBufferResource,
         .meshBuffer = meshBufferResource,
         .meshletBuffer = meshletBufferResource,
         .meshletInstanceBuffer = meshletCullingOutputResource,
         .transformBuffer = transformsResource,
-        .cameraBuffer = cameraResource,
+        .cullingViewBuffer = cullingViewResource,
         .feedbackBuffer = feedbackIndex,
         .outputCommand = commandResource,
         .maxMeshletInstancesCount = _globalData.maxMeshletCount,
         .meshCount = sceneInfo.meshCount,
         .cameraIndex = static_cast<i32>(sceneInfo.cullingCamera),
         .testAlpha = false,
+        .taskShading = taskShading,
+        .softwareMeshletBuffer = softwareMeshletResource,
+        .softwareCommand = softwareCommandResource,
+        .softwareThreshold = _renderSettings.softwareRasterThreshold,
         .cullMeshesPipeline = _cullMeshesPipeline,
-        .writeMeshletCullCommandPipeline = _writeMeshletCullCommandPipeline,
+        .expandMeshesPipeline = _expandMeshesPipeline,
         .culLMeshletsPipeline = _cullMeshletsPipeline,
-        .writeMeshletDrawCommandPipeline = _writeMeshletDrawCommandPipeline,
         .name = "cull_meshlets"
     });
 
@@ -325,10 +735,14 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
         .meshletInstanceBuffer = meshletCullingOutputResource,
         .transformBuffer = transformsResource,
         .cameraBuffer = cameraResource,
+        .cullingViewBuffer = cullingViewResource,
         .feedbackBuffer = feedbackIndex,
         .backbufferImage = visibilityBuffer,
         .depthImage = depthIndex,
+        .cameraIndex = static_cast<i32>(sceneInfo.primaryCamera),
+        .cullingCameraIndex = static_cast<i32>(sceneInfo.cullingCamera),
         .useMeshShading = _engine->meshShadingEnabled(),
+        .taskShading = taskShading,
         .meshShadingPipeline = _drawMeshletsPipelineMeshPath,
         .meshShadingAlphaPipeline = _drawMeshletsPipelineMeshAlphaPath,
         .writePrimitivesPipeline = _writePrimitivesPipeline,
@@ -338,6 +752,112 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
         .name = "draw_meshlets"
     });
 
+    if (softwareRaster) {
+        passes::rasteriseMeshlets(_renderGraph, {
+            .command = softwareCommandResource,
+            .globalBuffer = globalBufferResource,
+            .vertexBuffer = vertexBufferResource,
+            .indexBuffer = indexBufferResource,
+            .primitiveBuffer = primitiveBufferResource,
+            .meshletBuffer = meshletBufferResource,
+            .transformBuffer = transformsResource,
+            .cameraBuffer = cameraResource,
+            .feedbackBuffer = feedbackIndex,
+            .meshletInstanceBuffer = meshletCullingOutputResource,
+            .softwareMeshletBuffer = softwareMeshletResource.value(),
+            .visibilityImage = visibilityBuffer,
+            .depthImage = depthIndex,
+            .cameraIndex = static_cast<i32>(sceneInfo.primaryCamera),
+            .width = swapchain->width(),
+            .height = swapchain->height(),
+            .rasterisePipeline = _softwareRasterisePipeline,
+            .resolvePipeline = _softwareResolvePipeline,
+            .name = "software_raster"
+        });
+    }
+
+    bool shadowsEnabled = !debugEnabled && _renderSettings.shadows && sceneInfo.shadowCameraIndex >= 0;
+    canta::ImageIndex shadowAtlas = {};
+    if (shadowsEnabled) {
+        shadowAtlas = _renderGraph.addImage({
+            .matchesBackbuffer = false,
+            .width = SHADOW_MAP_RESOLUTION * sceneInfo.shadowCascadeCount,
+            .height = SHADOW_MAP_RESOLUTION,
+            .format = canta::Format::D32_SFLOAT,
+            .name = "shadow_atlas"
+        });
+        // all cascades are culled together so the cull passes run once per frame instead of once per cascade
+        const u32 viewStride = passes::meshletInstanceBufferSize(_globalData.maxMeshletCount);
+        auto shadowMeshletInstanceResource = _renderGraph.addBuffer({
+            .size = viewStride * sceneInfo.shadowCascadeCount,
+            .name = "shadow_meshlet_instance_buffer"
+        });
+        auto shadowCommandResource = _renderGraph.addBuffer({
+            .size = static_cast<u32>(sizeof(DispatchIndirectCommand) * 2 * sceneInfo.shadowCascadeCount),
+            .name = "shadow_meshlet_command_buffer"
+        });
+
+        passes::cullMeshletsMultiView(_renderGraph, {
+            .globalBuffer = globalBufferResource,
+            .meshBuffer = meshBufferResource,
+            .meshletBuffer = meshletBufferResource,
+            .meshletInstanceBuffer = shadowMeshletInstanceResource,
+            .transformBuffer = transformsResource,
+            .cullingViewBuffer = cullingViewResource,
+            .feedbackBuffer = feedbackIndex,
+            .outputCommand = shadowCommandResource,
+            .maxMeshletInstancesCount = _globalData.maxMeshletCount,
+            .meshCount = sceneInfo.meshCount,
+            .firstCameraIndex = sceneInfo.shadowCameraIndex,
+            .viewCount = sceneInfo.shadowCascadeCount,
+            .cullMeshesPipeline = _cullMeshesMultiViewPipeline,
+            .expandMeshesPipeline = _expandMeshesMultiViewPipeline,
+            .cullMeshletsPipeline = _cullMeshletsMultiViewPipeline,
+            .name = "shadow_cull_meshlets"
+        });
+
+        // the first cascade clears the atlas and each later one draws over the previous cascade's version of it, the
+        // last writes the atlas index the material pass reads
+        canta::ImageIndex cascadeInput = {};
+        for (u32 cascade = 0; cascade < sceneInfo.shadowCascadeCount; cascade++) {
+            i32 cameraIndex = sceneInfo.shadowCameraIndex + static_cast<i32>(cascade);
+            const bool lastCascade = cascade + 1 == sceneInfo.shadowCascadeCount;
+            auto cascadeOutput = lastCascade ? shadowAtlas : _renderGraph.addAlias(shadowAtlas);
+
+            passes::drawMeshlets(_renderGraph, {
+                .command = shadowCommandResource,
+                .globalBuffer = globalBufferResource,
+                .vertexBuffer = vertexBufferResource,
+                .indexBuffer = indexBufferResource,
+                .primitiveBuffer = primitiveBufferResource,
+                .meshletBuffer = meshletBufferResource,
+                .meshletInstanceBuffer = shadowMeshletInstanceResource,
+                .meshletInstanceOffset = viewStride * cascade,
+                .commandOffset = static_cast<u32>(sizeof(DispatchIndirectCommand) * 2 * cascade),
+                .transformBuffer = transformsResource,
+                .cameraBuffer = cameraResource,
+                .cullingViewBuffer = cullingViewResource,
+                .feedbackBuffer = feedbackIndex,
+                .depthImage = cascadeOutput,
+                .depthInput = cascadeInput,
+                .cameraIndex = cameraIndex,
+                .depthOnly = true,
+                .clearDepth = cascade == 0,
+                .viewportSize = { static_cast<f32>(SHADOW_MAP_RESOLUTION), static_cast<f32>(SHADOW_MAP_RESOLUTION) },
+                .viewportOffset = { static_cast<f32>(SHADOW_MAP_RESOLUTION * cascade), 0 },
+                .useMeshShading = _engine->meshShadingEnabled(),
+                .meshShadingPipeline = _drawShadowPipelineMeshPath,
+                .meshShadingAlphaPipeline = _drawShadowPipelineMeshAlphaPath,
+                .writePrimitivesPipeline = _writeShadowPrimitivesPipeline,
+                .vertexPipeline = _drawShadowPipelineVertexPath,
+                .maxMeshletInstancesCount = _globalData.maxMeshletCount,
+                .generatedPrimitiveCount = _globalData.maxIndirectIndexCount,
+                .name = "draw_shadows"
+            });
+            cascadeInput = cascadeOutput;
+        }
+    }
+
     auto [backbufferClear] = _renderGraph.addClearPass("clear_backbuffer", debugEnabled ? backbuffer : hdrBackbuffer)
             .aliasImageOutputs<1>();
 
@@ -364,47 +884,75 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
         });
 
     if (!debugEnabled) {
-        _renderGraph.addPass("material_pass", canta::PassType::COMPUTE)
+        auto lightBufferResource = _renderGraph.addBuffer({
+            .handle = sceneInfo.lightBuffer,
+            .name = "light_buffer"
+        });
+        auto clusterResource = _renderGraph.addBuffer({
+            .handle = _clusterBuffers[flyingIndex],
+            .name = "light_cluster_buffer"
+        });
+        auto clusterLightIndexResource = _renderGraph.addBuffer({
+            .handle = _clusterLightIndexBuffers[flyingIndex],
+            .name = "cluster_light_index_buffer"
+        });
+        passes::cullLights(_renderGraph, {
+            .globalBuffer = globalBufferResource,
+            .cameraBuffer = cameraResource,
+            .lightBuffer = lightBufferResource,
+            .clusterBuffer = clusterResource,
+            .lightIndexBuffer = clusterLightIndexResource,
+            .cameraIndex = static_cast<i32>(sceneInfo.primaryCamera),
+            .clusterCount = CLUSTER_COUNT,
+            .cullLightsPipeline = _cullLightsPipeline
+        });
+
+        auto& materialPass = _renderGraph.addPass("material_pass", canta::PassType::COMPUTE)
 
             .addStorageImageRead(visibilityBuffer, canta::PipelineStage::COMPUTE_SHADER)
             .addSampledRead(depthIndex, canta::PipelineStage::COMPUTE_SHADER)
             .addStorageImageRead(skyBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
             .addStorageBufferRead(globalBufferResource, canta::PipelineStage::COMPUTE_SHADER)
             .addStorageBufferRead(meshletCullingOutputResource, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(clusterResource, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(clusterLightIndexResource, canta::PipelineStage::COMPUTE_SHADER)
 
-            .addStorageImageWrite(hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageImageWrite(hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER);
 
-            .setExecuteFunction([&] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
-                auto visibilityBufferImage = graph.getImage(visibilityBuffer);
-                auto depthImage = graph.getImage(depthIndex);
-                auto backbufferImage = graph.getImage(hdrBackbuffer);
-                auto globalBuffer = graph.getBuffer(globalBufferResource);
-                auto meshletInstanceBuffer = graph.getBuffer(meshletCullingOutputResource);
+        if (shadowsEnabled)
+            materialPass.addSampledRead(shadowAtlas, canta::PipelineStage::COMPUTE_SHADER);
 
+        materialPass.setExecuteFunction([&] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto visibilityBufferImage = graph.getImage(visibilityBuffer);
+            auto depthImage = graph.getImage(depthIndex);
+            auto backbufferImage = graph.getImage(hdrBackbuffer);
+            auto globalBuffer = graph.getBuffer(globalBufferResource);
+            auto meshletInstanceBuffer = graph.getBuffer(meshletCullingOutputResource);
 
-                for (auto& material : _engine->assetManager().materials()) {
-                    cmd.bindPipeline(material.getVariant(Material::Variant::LIT));
-
-                    struct Push {
-                        u64 globalBuffer;
-                        u64 meshletInstanceBuffer;
-                        u64 materialBuffer;
-                        i32 visibilityIndex;
-                        i32 depthIndex;
-                        i32 backbufferIndex;
-                        i32 padding;
-                    };
-                    cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
-                            .globalBuffer = globalBuffer->address(),
-                            .meshletInstanceBuffer = meshletInstanceBuffer->address(),
-                            .materialBuffer = material.buffer()->address(),
-                            .visibilityIndex = visibilityBufferImage->defaultView().index(),
-                            .depthIndex = depthImage->defaultView().index(),
-                            .backbufferIndex = backbufferImage->defaultView().index(),
-                    });
-                    cmd.dispatchThreads(backbufferImage->width(), backbufferImage->height());
-                }
-            });
+
+            for (auto& material : _engine->assetManager().materials()) {
+                cmd.bindPipeline(material.getVariant(Material::Variant::LIT));
+
+                struct Push {
+                    u64 globalBuffer;
+                    u64 meshletInstanceBuffer;
+                    u64 materialBuffer;
+                    i32 visibilityIndex;
+                    i32 depthIndex;
+                    i32 backbufferIndex;
+                    i32 padding;
+                };
+                cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                        .globalBuffer = globalBuffer->address(),
+                        .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+                        .materialBuffer = material.buffer()->address(),
+                        .visibilityIndex = visibilityBufferImage->defaultView().index(),
+                        .depthIndex = depthImage->defaultView().index(),
+                        .backbufferIndex = backbufferImage->defaultView().index(),
+                });
+                cmd.dispatchThreads(backbufferImage->width(), backbufferImage->height());
+            }
+        });
 
         canta::ImageIndex bloomOutput = {};
         if (_renderSettings.bloom) {
@@ -413,157 +961,147 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
                 .width = swapchain->width(),
                 .height = swapchain->height(),
                 .hdrBackbuffer = hdrBackbuffer,
-                .globalBuffer = globalBufferResource,
                 .bilinearSampler = _bilinearSampler,
                 .downsamplePipeline = _bloomDownsamplePipeline,
-                .upsamplePipeline = _bloomUpsamplePipeline,
-                .compositePipeline = _bloomCompositePipeline
+                .upsamplePipeline = _bloomUpsamplePipeline
+            });
+        }
+
+        canta::BufferIndex exposureOutput = {};
+        if (_renderSettings.autoExposure) {
+            auto exposureResource = _renderGraph.addBuffer({
+                .handle = _exposureBuffer,
+                .name = "exposure_buffer"
+            });
+            exposureOutput = passes::autoExposure(_renderGraph, {
+                .hdrBackbuffer = hdrBackbuffer,
+                .exposureBuffer = exposureResource,
+                .minLogLuminance = _renderSettings.minLogLuminance,
+                .maxLogLuminance = _renderSettings.maxLogLuminance,
+                .adaptationCoefficient = std::clamp(1.f - std::exp(-dt * _renderSettings.exposureAdaptationRate), 0.f, 1.f),
+                .keyValue = _renderSettings.exposureKeyValue,
+                .histogramPipeline = _exposureHistogramPipeline,
+                .averagePipeline = _exposureAveragePipeline
             });
         }
 
-        _renderGraph.addPass("tonemap_pass", canta::PassType::COMPUTE)
+        // bloom composite and tonemap are fused, when the backbuffer isn't needed by the ui write straight to the swapchain
+        auto tonemapOutput = fusedOutput ? swapchainResource : backbuffer;
+        auto& tonemapPass = _renderGraph.addPass("tonemap_pass", canta::PassType::COMPUTE)
 
             .addStorageBufferRead(globalBufferResource, canta::PipelineStage::COMPUTE_SHADER)
-            .addStorageImageRead(_renderSettings.bloom ? bloomOutput : hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
-            .addStorageImageWrite(backbuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageImageRead(hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageImageWrite(tonemapOutput, canta::PipelineStage::COMPUTE_SHADER)
 
-            .setExecuteFunction([&, bloomOutput, hdrBackbuffer] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            .setExecuteFunction([&, bloomOutput, hdrBackbuffer, tonemapOutput] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
                 auto globalBuffer = graph.getBuffer(globalBufferResource);
-                auto tonemapInputImage = graph.getImage(_renderSettings.bloom ? bloomOutput : hdrBackbuffer);
-                auto backbufferImage = graph.getImage(backbuffer);
+                auto hdrImage = graph.getImage(hdrBackbuffer);
+                auto outputImage = graph.getImage(tonemapOutput);
 
                 cmd.bindPipeline(_tonemapPipeline);
 
                 struct Push {
                     u64 globalBuffer;
-                    i32 tonemapInputImage;
-                    i32 backbufferIndex;
+                    i32 hdrImage;
+                    i32 outputIndex;
                     i32 modeIndex;
-                    i32 padding;
+                    i32 bloomIndex;
+                    i32 bloomMipCount;
+                    i32 autoExposure;
                 };
                 cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
                     .globalBuffer = globalBuffer->address(),
-                    .tonemapInputImage = tonemapInputImage->defaultView().index(),
-                    .backbufferIndex = backbufferImage->defaultView().index(),
-                    .modeIndex = _renderSettings.tonemapModeIndex
+                    .hdrImage = hdrImage->defaultView().index(),
+                    .outputIndex = outputImage->defaultView().index(),
+                    .modeIndex = _renderSettings.tonemapModeIndex,
+                    .bloomIndex = _renderSettings.bloom ? graph.getImage(bloomOutput)->mipView(0).index() : -1,
+                    .bloomMipCount = _renderSettings.bloomMips,
+                    .autoExposure = _renderSettings.autoExposure
                 });
-                cmd.dispatchThreads(backbufferImage->width(), backbufferImage->height());
+                cmd.dispatchThreads(outputImage->width(), outputImage->height());
             });
+        if (_renderSettings.bloom)
+            tonemapPass.addStorageImageRead(bloomOutput, canta::PipelineStage::COMPUTE_SHADER);
+        if (_renderSettings.autoExposure)
+            tonemapPass.addStorageBufferRead(exposureOutput, canta::PipelineStage::COMPUTE_SHADER);
     }
 
-    if (_renderSettings.debugMeshletId) {
+    if (auto pipeline = asyncComputePipeline("debug/meshletId.comp", "debug_meshletId"); _renderSettings.debugMeshletId && pipeline) {
         passes::debugVisibilityBuffer(_renderGraph, {
             .name = "debug_meshletId",
             .visibilityBuffer = visibilityBuffer,
             .backbuffer = backbuffer,
             .globalBuffer = globalBufferResource,
             .meshletInstanceBuffer = meshletCullingOutputResource,
-            .pipeline = _engine->pipelineManager().getPipeline({
-                .compute = { .module = _engine->pipelineManager().getShader({
-                    .path = "debug/meshletId.comp",
-                    .stage = canta::ShaderStage::COMPUTE
-                })},
-                .name = "debug_meshletId"
-            })
+            .pipeline = pipeline
         }).addStorageImageRead(skyBackbuffer, canta::PipelineStage::COMPUTE_SHADER);
     }
-    if (_renderSettings.debugPrimitiveId) {
+    if (auto pipeline = asyncComputePipeline("debug/primitiveId.comp", "debug_primitiveId"); _renderSettings.debugPrimitiveId && pipeline) {
         passes::debugVisibilityBuffer(_renderGraph, {
             .name = "debug_primitiveId",
             .visibilityBuffer = visibilityBuffer,
             .backbuffer = backbuffer,
             .globalBuffer = globalBufferResource,
             .meshletInstanceBuffer = meshletCullingOutputResource,
-            .pipeline = _engine->pipelineManager().getPipeline({
-                .compute = { .module = _engine->pipelineManager().getShader({
-                    .path = "debug/primitiveId.comp",
-                    .stage = canta::ShaderStage::COMPUTE
-                })},
-                .name = "debug_primitiveId"
-            })
+            .pipeline = pipeline
         }).addStorageImageRead(skyBackbuffer, canta::PipelineStage::COMPUTE_SHADER);
     }
-    if (_renderSettings.debugMeshId) {
+    if (auto pipeline = asyncComputePipeline("debug/meshId.comp", "debug_meshId"); _renderSettings.debugMeshId && pipeline) {
         passes::debugVisibilityBuffer(_renderGraph, {
             .name = "debug_meshId",
             .visibilityBuffer = visibilityBuffer,
             .backbuffer = backbuffer,
             .globalBuffer = globalBufferResource,
             .meshletInstanceBuffer = meshletCullingOutputResource,
-            .pipeline = _engine->pipelineManager().getPipeline({
-                .compute = { .module = _engine->pipelineManager().getShader({
-                    .path = "debug/meshId.comp",
-                    .stage = canta::ShaderStage::COMPUTE
-                })},
-                .name = "debug_meshId"
-            })
+            .pipeline = pipeline
         }).addStorageImageRead(skyBackbuffer, canta::PipelineStage::COMPUTE_SHADER);
     }
-    if (_renderSettings.debugMaterialId) {
+    if (auto pipeline = asyncComputePipeline("debug/materialId.comp", "debug_materialId"); _renderSettings.debugMaterialId && pipeline) {
         passes::debugVisibilityBuffer(_renderGraph, {
             .name = "debug_materialId",
             .visibilityBuffer = visibilityBuffer,
             .backbuffer = backbuffer,
             .globalBuffer = globalBufferResource,
             .meshletInstanceBuffer = meshletCullingOutputResource,
-            .pipeline = _engine->pipelineManager().getPipeline({
-                .compute = { .module = _engine->pipelineManager().getShader({
-                    .path = "debug/materialId.comp",
-                    .stage = canta::ShaderStage::COMPUTE
-                })},
-                .name = "debug_materialId"
-            })
+            .pipeline = pipeline
         }).addStorageImageRead(skyBackbuffer, canta::PipelineStage::COMPUTE_SHADER);
     }
-    if (_renderSettings.debugFrustumIndex >= 0) {
+    if (auto pipeline = _renderSettings.debugFrustumIndex >= 0 ? debugFrustumPipeline() : canta::PipelineHandle{}) {
         passes::debugFrustum(_renderGraph, {
             .backbuffer = hdrBackbuffer,
             .depth = depthIndex,
             .globalBuffer = globalBufferResource,
             .cameraBuffer = cameraResource,
             .cameraIndex = _renderSettings.debugFrustumIndex,
-            .lineWidth = _renderSettings.debugLineWidth,
             .colour = _renderSettings.debugColour,
-            .engine = _engine
+            .pipeline = pipeline
         }).addStorageImageRead(skyBackbuffer, canta::PipelineStage::FRAGMENT_SHADER);
     }
-    if (_renderSettings.debugWireframe) {
+    if (auto pipeline = asyncComputePipeline("debug/wireframe_solid.comp", "debug_wireframe"); _renderSettings.debugWireframe && pipeline) {
         passes::debugVisibilityBuffer(_renderGraph, {
             .name = "debug_meshId",
             .visibilityBuffer = visibilityBuffer,
             .backbuffer = backbuffer,
             .globalBuffer = globalBufferResource,
             .meshletInstanceBuffer = meshletCullingOutputResource,
-            .pipeline = _engine->pipelineManager().getPipeline({
-                .compute = { .module = _engine->pipelineManager().getShader({
-                    .path = "debug/wireframe_solid.comp",
-                    .stage = canta::ShaderStage::COMPUTE
-                })},
-                .name = "debug_wireframe"
-            })
+            .pipeline = pipeline
         }).addStorageImageRead(skyBackbuffer, canta::PipelineStage::COMPUTE_SHADER);
     }
 
 
-    if (_renderSettings.mousePick) {
+    if (auto mousePickPipeline = asyncComputePipeline("util/mouse_pick.comp", "util_mouse_pick"); _renderSettings.mousePick && mousePickPipeline) {
         _renderGraph.addPass("mouse_pick", canta::PassType::COMPUTE)
 
             .addStorageImageRead(visibilityBuffer, canta::PipelineStage::COMPUTE_SHADER)
             .addStorageBufferWrite(feedbackIndex, canta::PipelineStage::COMPUTE_SHADER)
             .addStorageImageWrite(hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
 
-            .setExecuteFunction([&] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            .setExecuteFunction([&, mousePickPipeline] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
                 auto visibilityBufferImage = graph.getImage(visibilityBuffer);
                 auto globalBuffer = graph.getBuffer(globalBufferResource);
                 auto meshletInstanceBuffer = graph.getBuffer(meshletCullingOutputResource);
 
-                cmd.bindPipeline(_engine->pipelineManager().getPipeline({
-                    .compute = { .module = _engine->pipelineManager().getShader({
-                        .path = "util/mouse_pick.comp",
-                        .stage = canta::ShaderStage::COMPUTE
-                    })},
-                    .name = "util_mouse_pick"
-                }));
+                cmd.bindPipeline(mousePickPipeline);
 
                 struct Push {
                     u64 globalBuffer;
@@ -620,7 +1158,7 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
             .setExecuteFunction([&guiWorkspace, &swapchain](canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
                 guiWorkspace->context().render(ImGui::GetDrawData(), cmd, swapchain->format());
             });
-    } else {
+    } else if (!fusedOutput) {
         _renderGraph.addBlitPass("backbuffer_to_swapchain", backbuffer, swapchainResource);
     }
     _renderGraph.setBackbuffer(swapchainResource, canta::ImageLayout::PRESENT);
@@ -629,26 +1167,37 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
     std::memset(_feedbackBuffers[flyingIndex]->mapped().address(), 0, sizeof(FeedbackInfo));
 
     _globalData.maxMeshCount = sceneInfo.meshCount;
-    _globalData.maxMeshletCount = _globalData.maxMeshletCount = 10000000;
-    _globalData.maxIndirectIndexCount = 10000000 * 3;
     _globalData.maxLightCount = sceneInfo.lightCount;
-    _globalData.screenSize = { 1920, 1080 };
-    _globalData.exposure = 1.0f;
+    _globalData.exposure = _renderSettings.exposure;
     _globalData.bloomStrength = _renderSettings.bloomStrength;
     _globalData.primaryCamera = sceneInfo.primaryCamera,
     _globalData.cullingCamera = sceneInfo.cullingCamera;
     _globalData.textureSampler = _textureSampler.index();
     _globalData.depthSampler = _depthSampler.index();
+    _globalData.shadowMapIndex = -1;
+    _globalData.shadowCascadeCount = shadowsEnabled ? sceneInfo.shadowCascadeCount : 0;
+    _globalData.shadowBias = _renderSettings.shadowBias;
+    _globalData.shadowNormalOffset = _renderSettings.shadowNormalOffset;
+    _globalData.lodErrorThreshold = _renderSettings.clusterLod ? _renderSettings.lodErrorThreshold : 0;
+    _globalData.clusterGrid = { CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, MAX_LIGHTS_PER_CLUSTER };
     _globalData.meshBufferRef = sceneInfo.meshBuffer->address();
     _globalData.meshletBufferRef = _engine->meshletBuffer()->address();
     _globalData.vertexBufferRef = _engine->vertexBuffer()->address();
     _globalData.indexBufferRef = _engine->indexBuffer()->address();
     _globalData.primitiveBufferRef = _engine->primitiveBuffer()->address();
     _globalData.transformsBufferRef = sceneInfo.transformBuffer->address();
+    // a null reference makes the material shader fall back to inverting the transform
+    _globalData.normalMatrixBufferRef = _renderSettings.normalMatrices ? sceneInfo.normalMatrixBuffer->address() : 0;
     _globalData.cameraBufferRef = sceneInfo.cameraBuffer->address();
+    _globalData.cullingViewBufferRef = sceneInfo.cullingViewBuffer->address();
     _globalData.lightBufferRef = sceneInfo.lightBuffer->address();
     _globalData.feedbackInfoRef = _feedbackBuffers[flyingIndex]->address();
-    _globalBuffers[flyingIndex]->data(_globalData);
+    _globalData.exposureBufferRef = _exposureBuffer->address();
+    _globalData.clusterBufferRef = _clusterBuffers[flyingIndex]->address();
+    _globalData.clusterLightIndexBufferRef = _clusterLightIndexBuffers[flyingIndex]->address();
+    _globalData.meshletPageBufferRef = _engine->geometryStreamer().pageBufferAddress(flyingIndex);
+    _globalData.meshletGroupBufferRef = _engine->geometryStreamer().groupBufferAddress(flyingIndex);
+    _globalData.pageFeedbackBufferRef = _engine->geometryStreamer().feedbackBufferAddress(flyingIndex);
 
     auto result = _renderGraph.compile();
     if (!result.has_value()) {
@@ -656,6 +1205,11 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
         throw "cyclical graph found";
     }
 
+    // the shadow atlas is a transient image so its bindless index is only known once the graph is compiled
+    if (shadowsEnabled)
+        _globalData.shadowMapIndex = _renderGraph.getImage(shadowAtlas)->defaultView().index();
+    _globalBuffers[flyingIndex]->data(_globalData);
+
     auto waits = std::to_array({
         { _engine->device()->frameSemaphore(), _engine->device()->framePrevValue() },
         swapchain->acquireSemaphore()->getPair(),
@@ -673,5 +1227,7 @@ auto cen::Renderer::render(const cen::SceneInfo &sceneInfo, canta::Swapchain* sw
     _renderSettings.screenshotImage = {};
 //    _renderSettings.screenshotPath =
 
+    if (fusedOutput)
+        return {};
     return _renderGraph.getImage(backbuffer);
 }
\ No newline at end of file
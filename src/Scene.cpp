@@ -1,6 +1,7 @@
 #include <Cen/Scene.h>
 #include <Cen/Engine.h>
 #include <Canta/Buffer.h>
+#include <cstring>
 
 auto cen::Scene::create(cen::Scene::CreateInfo info) -> Scene {
     Scene scene = {};
@@ -18,13 +19,22 @@ auto cen::Scene::create(cen::Scene::CreateInfo info) -> Scene {
     }
     for (u32 i = 0; auto& buffer : scene._transformBuffer) {
         buffer = info.engine->device()->createBuffer({
-            .size = 100 * sizeof(ende::math::Mat4f),
+            .size = 100 * sizeof(AffineTransform),
             .usage = canta::BufferUsage::STORAGE,
             .type = canta::MemoryType::STAGING,
             .persistentlyMapped = true,
             .name = std::format("scene_transform_buffer: {}", i++)
         });
     }
+    for (u32 i = 0; auto& buffer : scene._normalMatrixBuffer) {
+        buffer = info.engine->device()->createBuffer({
+            .size = 100 * sizeof(mat3),
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("scene_normal_matrix_buffer: {}", i++)
+        });
+    }
     for (u32 i = 0; auto& buffer : scene._cameraBuffer) {
         buffer = info.engine->device()->createBuffer({
             .size = 100 * sizeof(GPUCamera),
@@ -34,6 +44,15 @@ auto cen::Scene::create(cen::Scene::CreateInfo info) -> Scene {
             .name = std::format("scene_camera_buffer: {}", i++)
         });
     }
+    for (u32 i = 0; auto& buffer : scene._cullingViewBuffer) {
+        buffer = info.engine->device()->createBuffer({
+            .size = 100 * sizeof(CullingView),
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("scene_culling_view_buffer: {}", i++)
+        });
+    }
     for (u32 i = 0; auto& buffer : scene._lightBuffer) {
         buffer = info.engine->device()->createBuffer({
             .size = 100 * sizeof(GPULight),
@@ -49,37 +68,172 @@ auto cen::Scene::create(cen::Scene::CreateInfo info) -> Scene {
     return scene;
 }
 
-void traverseNode(cen::Scene::SceneNode* node, ende::math::Mat4f worldTransform, std::vector<ende::math::Mat4f>& transforms) {
+auto toAffineTransform(const ende::math::Mat4f& transform) -> AffineTransform {
+    AffineTransform result = {};
+    for (u32 row = 0; row < 3; row++)
+        result.rows[row] = { transform[0][row], transform[1][row], transform[2][row], transform[3][row] };
+    return result;
+}
+
+void traverseNode(cen::Scene::SceneNode* node, ende::math::Mat4f worldTransform, std::vector<AffineTransform>& transforms, u32 staticMeshCount, bool& staticChanged) {
     if (node->transform.dirty())
         node->worldTransform = worldTransform * node->transform.local();
 
     if (node->type == cen::Scene::NodeType::MESH) {
-        transforms[node->index] = node->worldTransform;
+        transforms[node->index] = toAffineTransform(node->worldTransform);
+        if (node->transform.dirty() && static_cast<u32>(node->index) < staticMeshCount)
+            staticChanged = true;
     }
     for (auto& child : node->children) {
         if (node->transform.dirty())
             child->transform.setDirty(node->transform.dirty());
-        traverseNode(child.get(), node->worldTransform, transforms);
+        traverseNode(child.get(), node->worldTransform, transforms, staticMeshCount, staticChanged);
     }
     node->transform.setDirty(false);
 }
 
-auto cen::Scene::prepare() -> SceneInfo {
+// the cofactor matrix is the inverse transpose scaled by the determinant. the scale is removed when the shader
+// normalises but the sign is kept so mirrored transforms don't turn normals inside out.
+auto normalMatrix(const AffineTransform& transform) -> mat3 {
+    const ende::math::Vec3f x = { transform.rows[0][0], transform.rows[1][0], transform.rows[2][0] };
+    const ende::math::Vec3f y = { transform.rows[0][1], transform.rows[1][1], transform.rows[2][1] };
+    const ende::math::Vec3f z = { transform.rows[0][2], transform.rows[1][2], transform.rows[2][2] };
+    auto cross = [](const ende::math::Vec3f& a, const ende::math::Vec3f& b) -> ende::math::Vec3f {
+        return { a.y() * b.z() - a.z() * b.y(), a.z() * b.x() - a.x() * b.z(), a.x() * b.y() - a.y() * b.x() };
+    };
+    const auto cofactorX = cross(y, z);
+    const auto cofactorY = cross(z, x);
+    const auto cofactorZ = cross(x, y);
+    const f32 determinant = x.x() * cofactorX.x() + x.y() * cofactorX.y() + x.z() * cofactorX.z();
+    const f32 sign = determinant < 0 ? -1.f : 1.f;
+
+    mat3 result;
+    for (u32 i = 0; i < 3; i++) {
+        result[0][i] = cofactorX[i] * sign;
+        result[1][i] = cofactorY[i] * sign;
+        result[2][i] = cofactorZ[i] * sign;
+    }
+    return result;
+}
+
+template <typename F>
+void remapMeshNodes(cen::Scene::SceneNode* node, F&& remap) {
+    if (node->type == cen::Scene::NodeType::MESH)
+        node->index = remap(node->index);
+    for (auto& child : node->children)
+        remapMeshNodes(child.get(), remap);
+}
+
+// fits an orthographic camera around the slice of the view frustum between nearDepth and farDepth. the bounding
+// sphere keeps the cascade size stable under camera rotation and the center is snapped to shadow map texels so
+// edges don't shimmer as the camera moves.
+auto fitShadowCascade(const cen::Camera& viewCamera, const std::array<ende::math::Vec4f, 8>& frustumCorners, const ende::math::Quaternion& lightRotation, f32 nearDepth, f32 farDepth, f32 casterDistance) -> cen::Camera {
+    const auto forward = viewCamera.rotation().unit().front();
+    const auto cameraPosition = viewCamera.position();
+    auto viewDepth = [&](const ende::math::Vec3f& point) {
+        auto offset = point - cameraPosition;
+        return offset.x() * forward.x() + offset.y() * forward.y() + offset.z() * forward.z();
+    };
+
+    std::array<ende::math::Vec3f, 8> corners = {};
+    ende::math::Vec3f center = { 0, 0, 0 };
+    for (u32 i = 0; i < 4; i++) {
+        // far corner i shares its edge of the frustum with near corner 4 + (i + 1) % 4
+        const ende::math::Vec3f farCorner = { frustumCorners[i].x(), frustumCorners[i].y(), frustumCorners[i].z() };
+        const auto& nearCorner4 = frustumCorners[4 + (i + 1) % 4];
+        const ende::math::Vec3f nearCorner = { nearCorner4.x(), nearCorner4.y(), nearCorner4.z() };
+        const f32 nearCornerDepth = viewDepth(nearCorner);
+        const f32 depthRange = std::max(viewDepth(farCorner) - nearCornerDepth, 0.0001f);
+        const auto edge = farCorner - nearCorner;
+        corners[i * 2] = nearCorner + edge * ((nearDepth - nearCornerDepth) / depthRange);
+        corners[i * 2 + 1] = nearCorner + edge * ((farDepth - nearCornerDepth) / depthRange);
+        center = center + corners[i * 2] + corners[i * 2 + 1];
+    }
+    center = center * (1.f / 8.f);
+
+    f32 radius = 0;
+    for (auto& corner : corners) {
+        auto offset = corner - center;
+        radius = std::max(radius, std::sqrt(offset.x() * offset.x() + offset.y() * offset.y() + offset.z() * offset.z()));
+    }
+    radius = std::ceil(radius * 16.f) / 16.f;
+
+    const f32 texelsPerUnit = static_cast<f32>(cen::SHADOW_MAP_RESOLUTION) / (radius * 2.f);
+    auto lightSpaceCenter = lightRotation.inverse().toMat().transform(ende::math::Vec4f{ center.x(), center.y(), center.z(), 1 });
+    lightSpaceCenter = {
+        std::floor(lightSpaceCenter.x() * texelsPerUnit) / texelsPerUnit,
+        std::floor(lightSpaceCenter.y() * texelsPerUnit) / texelsPerUnit,
+        lightSpaceCenter.z(),
+        1
+    };
+    const auto snappedCenter = lightRotation.toMat().transform(lightSpaceCenter);
+
+    auto camera = cen::Camera::create(cen::Camera::CreateOrthographicInfo{
+        .position = { snappedCenter.x(), snappedCenter.y(), snappedCenter.z() },
+        .rotation = lightRotation,
+        .left = -radius,
+        .right = radius,
+        .top = radius,
+        .bottom = -radius,
+        .near = -(radius + casterDistance),
+        .far = radius
+    });
+    // reverse z to match the GEQUAL depth test used by the meshlet pipelines
+    camera.setProjection(ende::math::orthographic(-radius, radius, -radius, radius, radius, -(radius + casterDistance)));
+    camera.updateFrustum();
+    return camera;
+}
+
+auto cen::Scene::prepare(const Renderer::RenderSettings& settings) -> SceneInfo {
     std::unique_lock lock(*_mutex);
+    if (_partitionDirty)
+        partitionMeshes();
     u32 flyingIndex = _engine->device()->flyingIndex();
+    // these are written through their mapping so they are regrown host mapped
     if (_meshBuffer[flyingIndex]->size() < _meshes.size() * sizeof(GPUMesh)) {
         _meshBuffer[flyingIndex] = _engine->device()->createBuffer({
-            .size = static_cast<u32>(_meshes.size() * sizeof(GPUMesh))
+            .size = static_cast<u32>(_meshes.size() * sizeof(GPUMesh)),
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("scene_mesh_buffer: {}", flyingIndex)
         }, _meshBuffer[flyingIndex]);
+        _staticDirty[flyingIndex] = true;
     }
-    if (_transformBuffer[flyingIndex]->size() < _worldTransforms.size() * sizeof(ende::math::Mat4f)) {
+    if (_transformBuffer[flyingIndex]->size() < _worldTransforms.size() * sizeof(AffineTransform)) {
         _transformBuffer[flyingIndex] = _engine->device()->createBuffer({
-            .size = static_cast<u32>(_worldTransforms.size() * sizeof(ende::math::Mat4f))
+            .size = static_cast<u32>(_worldTransforms.size() * sizeof(AffineTransform)),
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("scene_transform_buffer: {}", flyingIndex)
         }, _transformBuffer[flyingIndex]);
+        _staticDirty[flyingIndex] = true;
+    }
+    if (settings.normalMatrices && _normalMatrixBuffer[flyingIndex]->size() < _worldTransforms.size() * sizeof(mat3)) {
+        _normalMatrixBuffer[flyingIndex] = _engine->device()->createBuffer({
+            .size = static_cast<u32>(_worldTransforms.size() * sizeof(mat3)),
+            .usage = canta::BufferUsage::STORAGE,
+            .type = canta::MemoryType::STAGING,
+            .persistentlyMapped = true,
+            .name = std::format("scene_normal_matrix_buffer: {}", flyingIndex)
+        }, _normalMatrixBuffer[flyingIndex]);
+        _staticDirty[flyingIndex] = true;
     }
 
-    traverseNode(_rootNode.get(), ende::math::identity<4, f32>(), _worldTransforms);
+    bool staticMoved = false;
+    traverseNode(_rootNode.get(), ende::math::identity<4, f32>(), _worldTransforms, _staticMeshCount, staticMoved);
     assert(_meshes.size() == _worldTransforms.size());
+    if (staticMoved) {
+        for (auto& dirty : _staticDirty)
+            dirty = true;
+    }
+    if (settings.normalMatrices != _normalMatricesEnabled) {
+        // the static range of the normal matrices is stale in every frame in flight when toggled on
+        _normalMatricesEnabled = settings.normalMatrices;
+        for (auto& dirty : _staticDirty)
+            dirty = true;
+    }
 
     _gpuCameras.clear();
     for (u32 cameraIndex = 0; cameraIndex < _cameras.size(); cameraIndex++) {
@@ -88,20 +242,37 @@ auto cen::Scene::prepare() -> SceneInfo {
     }
 
     _gpuLights.clear();
+    i32 shadowCameraIndex = -1;
+    u32 shadowCascadeCount = 0;
     for (auto& light : _lights) {
+        light.setCameraIndex(-1);
         if (light.shadowing()) {
             i32 cameraIndex = _gpuCameras.size();
             if (light.type() == Light::Type::DIRECTIONAL) {
-                auto camera = Camera::create({
-                    .position = light.position(),
-                    .rotation = light.rotation(),
-                    .fov = ende::math::rad(45),
-                    .width = 100,
-                    .height = 100,
-                    .near = 0.1,
-                    .far = 1000
-                });
-                _gpuCameras.push_back(camera.gpuCamera());
+                // only a single directional light gets cascades as they all share one shadow atlas
+                if (settings.shadows && shadowCameraIndex < 0 && _primaryCamera >= 0) {
+                    auto& viewCamera = primaryCamera();
+                    const auto frustumCorners = viewCamera.frustumCorners();
+                    // cameras look down their front axis while light travels against it
+                    const auto shadowRotation = (light.rotation() * ende::math::Quaternion({ 0, 1, 0 }, ende::math::rad(180))).unit();
+                    const u32 cascadeCount = std::clamp(settings.shadowCascadeCount, 1, MAX_SHADOW_CASCADES);
+                    const f32 near = viewCamera.near();
+                    const f32 far = std::min(viewCamera.far(), settings.shadowDistance);
+
+                    f32 splitNear = near;
+                    for (u32 cascade = 0; cascade < cascadeCount; cascade++) {
+                        const f32 p = static_cast<f32>(cascade + 1) / static_cast<f32>(cascadeCount);
+                        const f32 logSplit = near * std::pow(far / near, p);
+                        const f32 uniformSplit = near + (far - near) * p;
+                        const f32 splitFar = settings.shadowCascadeSplitLambda * logSplit + (1 - settings.shadowCascadeSplitLambda) * uniformSplit;
+                        auto camera = fitShadowCascade(viewCamera, frustumCorners, shadowRotation, splitNear, splitFar, settings.shadowDistance);
+                        _gpuCameras.push_back(camera.gpuCamera());
+                        splitNear = splitFar;
+                    }
+                    light.setCameraIndex(cameraIndex);
+                    shadowCameraIndex = cameraIndex;
+                    shadowCascadeCount = cascadeCount;
+                }
             } else {
                 auto camera = Camera::create({
                      .position = light.position(),
@@ -138,15 +309,24 @@ auto cen::Scene::prepare() -> SceneInfo {
                     camera.setRotation(cameraRotation);
                     _gpuCameras.push_back(camera.gpuCamera());
                 }
+                light.setCameraIndex(cameraIndex);
             }
-            light.setCameraIndex(cameraIndex);
-
         }
         _gpuLights.push_back(light.gpuLight());
     }
 
-    _meshBuffer[flyingIndex]->data(_meshes);
-    _transformBuffer[flyingIndex]->data(_worldTransforms);
+    // each frame in flight has its own copy of the buffers so the static range is uploaded once per copy
+    const u32 uploadOffset = _staticDirty[flyingIndex] ? 0 : _staticMeshCount;
+    const u32 uploadCount = _meshes.size() - uploadOffset;
+    std::memcpy(static_cast<GPUMesh*>(_meshBuffer[flyingIndex]->mapped().address()) + uploadOffset, _meshes.data() + uploadOffset, uploadCount * sizeof(GPUMesh));
+    std::memcpy(static_cast<AffineTransform*>(_transformBuffer[flyingIndex]->mapped().address()) + uploadOffset, _worldTransforms.data() + uploadOffset, uploadCount * sizeof(AffineTransform));
+    if (_normalMatricesEnabled) {
+        _normalMatrices.resize(_worldTransforms.size());
+        for (u32 i = uploadOffset; i < _worldTransforms.size(); i++)
+            _normalMatrices[i] = normalMatrix(_worldTransforms[i]);
+        std::memcpy(static_cast<mat3*>(_normalMatrixBuffer[flyingIndex]->mapped().address()) + uploadOffset, _normalMatrices.data() + uploadOffset, uploadCount * sizeof(mat3));
+    }
+    _staticDirty[flyingIndex] = false;
 
     if (_cameraBuffer[flyingIndex]->size() < _gpuCameras.size() * sizeof(GPUCamera)) {
         _cameraBuffer[flyingIndex] = _engine->device()->createBuffer({
@@ -155,6 +335,22 @@ auto cen::Scene::prepare() -> SceneInfo {
     }
     _cameraBuffer[flyingIndex]->data(_gpuCameras);
 
+    _cullingViews.clear();
+    for (auto& camera : _gpuCameras) {
+        CullingView view = {};
+        for (u32 i = 0; i < 6; i++)
+            view.planes[i] = camera.frustum.planes[i];
+        view.view = camera.view;
+        view.projection = { camera.projection[0][0], camera.projection[1][1], camera.near, camera.far };
+        _cullingViews.push_back(view);
+    }
+    if (_cullingViewBuffer[flyingIndex]->size() < _cullingViews.size() * sizeof(CullingView)) {
+        _cullingViewBuffer[flyingIndex] = _engine->device()->createBuffer({
+            .size = static_cast<u32>(_cullingViews.size() * sizeof(CullingView))
+        }, _cullingViewBuffer[flyingIndex]);
+    }
+    _cullingViewBuffer[flyingIndex]->data(_cullingViews);
+
     if (_lightBuffer[flyingIndex]->size() < _gpuLights.size() * sizeof(GPULight)) {
         _lightBuffer[flyingIndex] = _engine->device()->createBuffer({
             .size = static_cast<u32>(_gpuLights.size() * sizeof(GPULight))
@@ -167,14 +363,20 @@ auto cen::Scene::prepare() -> SceneInfo {
     return {
         .meshBuffer = _meshBuffer[flyingIndex],
         .transformBuffer = _transformBuffer[flyingIndex],
+        .normalMatrixBuffer = _normalMatrixBuffer[flyingIndex],
         .cameraBuffer = _cameraBuffer[flyingIndex],
+        .cullingViewBuffer = _cullingViewBuffer[flyingIndex],
         .lightBuffer = _lightBuffer[flyingIndex],
         .meshCount = meshCount(),
+        .meshletCount = totalMeshlets(),
+        .primitiveCount = totalPrimtives(),
         .cameraCount = static_cast<u32>(_gpuCameras.size()),
         .primaryCamera = static_cast<u32>(_primaryCamera),
         .cullingCamera = static_cast<u32>(_cullingCamera),
         .lightCount = static_cast<u32>(_gpuLights.size()),
-        .sunIndex = _lights.front().type() == Light::DIRECTIONAL ? 0 : -1
+        .sunIndex = _lights.front().type() == Light::DIRECTIONAL ? 0 : -1,
+        .shadowCameraIndex = shadowCameraIndex,
+        .shadowCascadeCount = shadowCascadeCount
     };
 }
 
@@ -198,29 +400,57 @@ auto cen::Scene::addNode(std::string_view name, const cen::Transform &transform,
     }
 }
 
-auto cen::Scene::addModel(std::string_view name, const cen::Model &model, const cen::Transform &transform, cen::Scene::SceneNode *parent) -> SceneNode * {
+auto cen::Scene::addModel(std::string_view name, const cen::Model &model, const cen::Transform &transform, cen::Scene::SceneNode *parent, Mobility mobility) -> SceneNode * {
     auto node = addNode(name, transform, parent);
     for (auto& mesh : model.meshes) {
-        addMesh(name, mesh, Transform::create({}), node);
+        addMesh(name, mesh, Transform::create({}), node, mobility);
     }
     return node;
 }
 
-auto cen::Scene::addMesh(std::string_view name, const cen::Mesh &mesh, const Transform &transform, cen::Scene::SceneNode *parent) -> SceneNode* {
+auto cen::Scene::addMesh(std::string_view name, const cen::Mesh &mesh, const Transform &transform, cen::Scene::SceneNode *parent, Mobility mobility) -> SceneNode* {
     std::unique_lock lock(*_mutex);
-    auto index = _meshes.size();
-    _meshes.push_back({
+    const ende::math::Vec3f center = {
+        (mesh.min.x() + mesh.max.x()) * 0.5f,
+        (mesh.min.y() + mesh.max.y()) * 0.5f,
+        (mesh.min.z() + mesh.max.z()) * 0.5f
+    };
+    const ende::math::Vec3f halfExtent = {
+        (mesh.max.x() - mesh.min.x()) * 0.5f,
+        (mesh.max.y() - mesh.min.y()) * 0.5f,
+        (mesh.max.z() - mesh.min.z()) * 0.5f
+    };
+    const f32 radius = std::sqrt(halfExtent.x() * halfExtent.x() + halfExtent.y() * halfExtent.y() + halfExtent.z() * halfExtent.z());
+    GPUMesh gpuMesh = {
         .meshletOffset = mesh.meshletOffset,
         .meshletCount = mesh.meshletCount,
         .min = mesh.min,
         .max = mesh.max,
         .materialId = mesh.materialInstance ? static_cast<i32>(mesh.materialInstance->material()->id()) : -1,
         .materialOffset = mesh.materialInstance ? mesh.materialInstance->index() : 0,
-        .alphaMapIndex = mesh.alphaMapIndex
-    });
-    _worldTransforms.push_back(transform.local());
+        .alphaMapIndex = mesh.alphaMapIndex,
+        .mobility = static_cast<u32>(mobility),
+        .boundingSphere = { center.x(), center.y(), center.z(), radius },
+        .flags = mesh.doubleSided ? MESH_FLAG_DOUBLE_SIDED : 0u
+    };
+    const i32 index = _meshes.size();
+    _meshes.push_back(gpuMesh);
+    _worldTransforms.push_back(toAffineTransform(transform.local()));
+    if (mobility == Mobility::STATIC) {
+        // static meshes appended before any dynamic mesh extend the static range in place, otherwise the meshes are
+        // partitioned once in prepare instead of shifting the dynamic range for every mesh added
+        if (static_cast<u32>(index) == _staticMeshCount)
+            _staticMeshCount++;
+        else
+            _partitionDirty = true;
+        for (auto& dirty : _staticDirty)
+            dirty = true;
+    }
 
     assert(_meshes.size() == _worldTransforms.size());
+    _maxMeshlets = std::max(_maxMeshlets, mesh.meshletCount);
+    _totalMeshlets += mesh.meshletCount;
+    _totalPrimitives += mesh.primitiveCount;
 
     auto node = std::make_unique<SceneNode>();
     node->type = NodeType::MESH;
@@ -241,9 +471,53 @@ auto cen::Scene::addMesh(std::string_view name, const cen::Mesh &mesh, const Tra
 }
 
 auto cen::Scene::getMesh(cen::Scene::SceneNode *node) -> GPUMesh & {
+    // the mesh can be edited through the returned reference so a static mesh has its range uploaded again
+    if (getMobility(node) == Mobility::STATIC) {
+        for (auto& dirty : _staticDirty)
+            dirty = true;
+    }
     return _meshes[node->index];
 }
 
+auto cen::Scene::getMobility(cen::Scene::SceneNode *node) const -> Mobility {
+    return static_cast<Mobility>(_meshes[node->index].mobility);
+}
+
+void cen::Scene::setMobility(cen::Scene::SceneNode *node, cen::Scene::Mobility mobility) {
+    std::unique_lock lock(*_mutex);
+    if (getMobility(node) == mobility)
+        return;
+
+    _meshes[node->index].mobility = static_cast<u32>(mobility);
+    _partitionDirty = true;
+    for (auto& dirty : _staticDirty)
+        dirty = true;
+}
+
+void cen::Scene::partitionMeshes() {
+    // stable so meshes keep their relative order within each range, then every mesh node is remapped in one pass
+    std::vector<i32> remap(_meshes.size());
+    std::vector<GPUMesh> meshes = {};
+    std::vector<AffineTransform> transforms = {};
+    meshes.reserve(_meshes.size());
+    transforms.reserve(_worldTransforms.size());
+    for (auto mobility : { Mobility::STATIC, Mobility::DYNAMIC }) {
+        for (u32 i = 0; i < _meshes.size(); i++) {
+            if (_meshes[i].mobility != static_cast<u32>(mobility))
+                continue;
+            remap[i] = meshes.size();
+            meshes.push_back(_meshes[i]);
+            transforms.push_back(_worldTransforms[i]);
+        }
+        if (mobility == Mobility::STATIC)
+            _staticMeshCount = meshes.size();
+    }
+    remapMeshNodes(_rootNode.get(), [&remap] (i32 meshIndex) { return remap[meshIndex]; });
+    _meshes = std::move(meshes);
+    _worldTransforms = std::move(transforms);
+    _partitionDirty = false;
+}
+
 auto cen::Scene::addCamera(std::string_view name, const cen::Camera &camera, const cen::Transform &transform, cen::Scene::SceneNode *parent) -> SceneNode * {
     std::unique_lock lock(*_mutex);
     auto index = _cameras.size();
@@ -0,0 +1,213 @@
+#include <Cen/ShaderCache.h>
+#include <Cen/Engine.h>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+    // bump when the cache layout or anything that changes the compiled output without touching the sources changes
+    constexpr u32 SHADER_CACHE_VERSION = 1;
+    constexpr u32 SHADER_CACHE_MAGIC = 0x43534843;
+
+    struct CacheHeader {
+        u32 magic = SHADER_CACHE_MAGIC;
+        u32 version = SHADER_CACHE_VERSION;
+        u64 key = 0;
+        u32 wordCount = 0;
+    };
+
+    // fnv-1a, stable across runs unlike std::hash
+    auto hashBytes(u64 hash, std::string_view bytes) -> u64 {
+        for (auto byte : bytes) {
+            hash ^= static_cast<u8>(byte);
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    auto readFile(const std::filesystem::path& path) -> std::string {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        return stream.str();
+    }
+
+    // hashes the file and every file it includes. includes are resolved against the including file, the shader root
+    // then the include paths by file name. ones found in none of them only have their name hashed.
+    auto hashSource(u64 hash, const std::filesystem::path& path, const std::filesystem::path& rootPath, const std::unordered_map<std::string, std::filesystem::path>& includes, std::unordered_set<std::string>& visited) -> u64 {
+        if (!visited.insert(path.string()).second)
+            return hash;
+        auto source = readFile(path);
+        hash = hashBytes(hash, source);
+
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line)) {
+            auto directive = line.find_first_not_of(" \t");
+            if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0)
+                continue;
+            auto begin = line.find('"', directive);
+            auto end = begin != std::string::npos ? line.find('"', begin + 1) : std::string::npos;
+            if (end == std::string::npos)
+                continue;
+            std::filesystem::path include = line.substr(begin + 1, end - begin - 1);
+            if (auto relative = path.parent_path() / include; std::filesystem::exists(relative))
+                hash = hashSource(hash, relative, rootPath, includes, visited);
+            else if (std::filesystem::exists(rootPath / include))
+                hash = hashSource(hash, rootPath / include, rootPath, includes, visited);
+            else if (auto it = includes.find(include.filename().string()); it != includes.end())
+                hash = hashSource(hash, it->second, rootPath, includes, visited);
+            else
+                hash = hashBytes(hash, include.string());
+        }
+        return hash;
+    }
+
+}
+
+auto cen::ShaderCache::create(CreateInfo info) -> ShaderCache {
+    ShaderCache cache = {};
+    cache._engine = info.engine;
+    cache._mutex = std::make_unique<std::mutex>();
+    cache._rootPath = info.rootPath;
+    cache._cachePath = info.cachePath;
+    if (!cache._cachePath.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(cache._cachePath, error);
+        if (error) {
+            std::printf("failed to create shader cache at %s, compiling shaders from source\n", cache._cachePath.c_str());
+            cache._cachePath.clear();
+        }
+    }
+    if (cache.enabled()) {
+        for (auto& includePath : info.includePaths) {
+            std::error_code error;
+            for (auto it = std::filesystem::recursive_directory_iterator(includePath, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+                if (it->is_regular_file() && it->path().extension() == ".glsl")
+                    cache._includes.try_emplace(it->path().filename().string(), it->path());
+            }
+        }
+    }
+    return cache;
+}
+
+auto cen::ShaderCache::getShader(const ShaderInfo& info) -> canta::ShaderHandle {
+    std::string name = std::format("{}:{}", info.path.string(), static_cast<u32>(info.stage));
+    for (auto& macro : info.macros)
+        name += std::format(":{}={}", macro.name, macro.value);
+
+    // the first request for a shader builds it, later ones wait on its future instead of building it again
+    std::promise<canta::ShaderHandle> promise;
+    {
+        std::unique_lock lock(*_mutex);
+        if (auto it = _shaders.find(name); it != _shaders.end()) {
+            auto future = it->second;
+            lock.unlock();
+            return future.get();
+        }
+        _shaders.insert(std::make_pair(name, promise.get_future().share()));
+    }
+
+    const auto compileFromSource = [&] {
+        std::unique_lock lock(_engine->pipelineMutex());
+        return _engine->pipelineManager().getShader({
+            .path = info.path,
+            .macros = info.macros,
+            .stage = info.stage
+        });
+    };
+
+    if (!enabled()) {
+        auto shader = compileFromSource();
+        promise.set_value(shader);
+        return shader;
+    }
+
+    const auto shaderKey = key(info);
+    auto spirv = read(shaderKey);
+    const bool hit = !spirv.empty();
+    if (!hit) {
+        auto compiled = _engine->pipelineManager().compileShader({
+            .path = info.path,
+            .macros = info.macros,
+            .stage = info.stage
+        });
+        if (compiled) {
+            spirv = std::move(compiled.value());
+            write(shaderKey, spirv);
+        }
+    }
+
+    // anything that failed to compile goes through the pipeline manager so its errors are reported as before
+    canta::ShaderHandle shader = {};
+    if (spirv.empty())
+        shader = compileFromSource();
+    else {
+        std::unique_lock lock(_engine->pipelineMutex());
+        shader = _engine->pipelineManager().getShader({
+            .spirv = spirv,
+            .stage = info.stage,
+            .name = name
+        });
+    }
+    {
+        std::unique_lock lock(*_mutex);
+        if (hit)
+            _hits++;
+        else
+            _misses++;
+    }
+    promise.set_value(shader);
+    return shader;
+}
+
+auto cen::ShaderCache::key(const ShaderInfo& info) const -> u64 {
+    u64 hash = 0xcbf29ce484222325;
+    hash = hashBytes(hash, std::string_view(reinterpret_cast<const char*>(&SHADER_CACHE_VERSION), sizeof(SHADER_CACHE_VERSION)));
+    hash = hashBytes(hash, std::to_string(static_cast<u32>(info.stage)));
+    for (auto& macro : info.macros) {
+        hash = hashBytes(hash, macro.name);
+        hash = hashBytes(hash, "=");
+        hash = hashBytes(hash, macro.value);
+    }
+    std::unordered_set<std::string> visited = {};
+    return hashSource(hash, _rootPath / info.path, _rootPath, _includes, visited);
+}
+
+auto cen::ShaderCache::read(u64 key) const -> std::vector<u32> {
+    std::ifstream file(_cachePath / std::format("{:016x}.spv", key), std::ios::binary);
+    if (!file)
+        return {};
+    CacheHeader header = {};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key || header.wordCount == 0)
+        return {};
+    std::vector<u32> spirv(header.wordCount);
+    file.read(reinterpret_cast<char*>(spirv.data()), spirv.size() * sizeof(u32));
+    if (!file)
+        return {};
+    return spirv;
+}
+
+void cen::ShaderCache::write(u64 key, std::span<const u32> spirv) const {
+    // written next to the entry and renamed over it so a concurrent or interrupted writer never leaves a partial file
+    const auto path = _cachePath / std::format("{:016x}.spv", key);
+    auto tempPath = path;
+    tempPath += std::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        CacheHeader header = {
+            .key = key,
+            .wordCount = static_cast<u32>(spirv.size())
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(u32));
+        if (!file)
+            return;
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+}
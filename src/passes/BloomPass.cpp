@@ -20,11 +20,6 @@ auto cen::passes::bloom(canta::RenderGraph &graph, cen::passes::BloomParams para
         .format = canta::Format::RGBA32_SFLOAT,
         .name = "bloom_upsample"
     });
-    auto bloomOutput = graph.addImage({
-        .matchesBackbuffer = true,
-        .format = canta::Format::RGBA32_SFLOAT,
-        .name = "bloom_final"
-    });
 
     auto downsampleInput = graph.addAlias(bloomDownsampleIndex);
     for (u32 i = 0; i < params.mips; i++) {
@@ -85,32 +80,5 @@ auto cen::passes::bloom(canta::RenderGraph &graph, cen::passes::BloomParams para
         upsampleInput = upsampleOutput;
     }
 
-    graph.addPass("bloom_composite", canta::PassType::COMPUTE, bloomGroup)
-        .addStorageImageRead(upsampleInput, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageImageRead(params.hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageImageWrite(bloomOutput, canta::PipelineStage::COMPUTE_SHADER)
-        .setExecuteFunction([params, upsampleInput, bloomOutput] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
-            auto globalBuffer = graph.getBuffer(params.globalBuffer);
-            auto upsampleImage = graph.getImage(upsampleInput);
-            auto hdrImage = graph.getImage(params.hdrBackbuffer);
-            auto outputImage = graph.getImage(bloomOutput);
-
-            cmd.bindPipeline(params.compositePipeline);
-            struct Push {
-                u64 globalBuffer;
-                i32 upsample;
-                i32 hdr;
-                i32 output;
-                i32 mipCount;
-            };
-            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
-                .globalBuffer = globalBuffer->address(),
-                .upsample = upsampleImage->defaultView().index(),
-                .hdr = hdrImage->defaultView().index(),
-                .output = outputImage->defaultView().index(),
-                .mipCount = params.mips
-            });
-            cmd.dispatchThreads(outputImage->width(), outputImage->height());
-        });
-    return bloomOutput;
+    return upsampleInput;
 }
\ No newline at end of file
@@ -10,12 +10,11 @@ namespace cen::passes {
         u32 width;
         u32 height;
         canta::ImageIndex hdrBackbuffer;
-        canta::BufferIndex globalBuffer;
         canta::SamplerHandle bilinearSampler;
         canta::PipelineHandle downsamplePipeline;
         canta::PipelineHandle upsamplePipeline;
-        canta::PipelineHandle compositePipeline;
     };
+    // returns the bloom upsample chain, mip 0 is composited with the hdr image in the tonemap pass
     auto bloom(canta::RenderGraph& graph, BloomParams params) -> canta::ImageIndex;
 
 }
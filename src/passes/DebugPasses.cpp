@@ -1,5 +1,4 @@
 #include "DebugPasses.h"
-#include <Cen/Engine.h>
 
 auto cen::passes::debugVisibilityBuffer(canta::RenderGraph &graph, cen::passes::VisibilityDebugParams params) -> canta::RenderPass& {
     auto& debugVisibilityBufferpass = graph.addPass(params.name, canta::PassType::COMPUTE);
@@ -45,31 +44,8 @@ auto cen::passes::debugFrustum(canta::RenderGraph &graph, cen::passes::FrustumDe
     debugFrustumPass.setExecuteFunction([params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
         auto globalBuffer = graph.getBuffer(params.globalBuffer);
         auto cameraBuffer = graph.getBuffer(params.cameraBuffer);
-        auto backbuffer = graph.getImage(params.backbuffer);
 
-        cmd.bindPipeline(params.engine->pipelineManager().getPipeline({
-            .vertex = { .module = params.engine->pipelineManager().getShader({
-                .path = "debug/frustum.vert",
-                .stage = canta::ShaderStage::VERTEX
-            })},
-            .fragment = { .module = params.engine->pipelineManager().getShader({
-                .path = "debug/solid_colour.frag",
-                .stage = canta::ShaderStage::FRAGMENT
-            })},
-            .rasterState = {
-                .cullMode = canta::CullMode::NONE,
-                .polygonMode = canta::PolygonMode::LINE,
-                .lineWidth = params.lineWidth
-            },
-            .depthState = {
-                .test = true,
-                .write = false,
-                .compareOp = canta::CompareOp::GEQUAL
-            },
-            .colourFormats = { backbuffer->format() },
-            .depthFormat = canta::Format::D32_SFLOAT,
-            .name = "debug_frustum"
-        }));
+        cmd.bindPipeline(params.pipeline);
 
         struct Push {
             u64 globalBuffer;
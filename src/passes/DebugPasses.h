@@ -3,10 +3,6 @@
 
 #include <Canta/RenderGraph.h>
 
-namespace cen {
-    class Engine;
-}
-
 namespace cen::passes {
 
     struct VisibilityDebugParams {
@@ -25,9 +21,8 @@ namespace cen::passes {
         canta::BufferIndex globalBuffer;
         canta::BufferIndex cameraBuffer;
         i32 cameraIndex;
-        f32 lineWidth;
         std::array<f32, 3> colour;
-        cen::Engine* engine;
+        canta::PipelineHandle pipeline;
     };
     auto debugFrustum(canta::RenderGraph& graph, FrustumDebugParam params) -> canta::RenderPass&;
 
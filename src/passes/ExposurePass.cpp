@@ -0,0 +1,79 @@
+#include "ExposurePass.h"
+#include <Ende/util/colour.h>
+#include <cen.glsl>
+
+auto cen::passes::autoExposure(canta::RenderGraph &graph, cen::passes::AutoExposureParams params) -> canta::BufferIndex {
+    auto exposureGroup = graph.getGroup("auto_exposure", ende::util::rgb(214, 131, 21));
+
+    auto histogramIndex = graph.addBuffer({
+        .size = sizeof(u32) * EXPOSURE_HISTOGRAM_BINS,
+        .name = "luminance_histogram"
+    });
+
+    auto& clearHistogramPass = graph.addPass("clear_histogram", canta::PassType::TRANSFER, exposureGroup)
+        .addTransferWrite(histogramIndex)
+        .setExecuteFunction([histogramIndex] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto histogramBuffer = graph.getBuffer(histogramIndex);
+            cmd.clearBuffer(histogramBuffer);
+        });
+    auto [ histogramClear ] = clearHistogramPass.aliasBufferOutputs<1>();
+
+    graph.addPass("luminance_histogram", canta::PassType::COMPUTE, exposureGroup)
+        .addStorageImageRead(params.hdrBackbuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(histogramClear, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(histogramIndex, canta::PipelineStage::COMPUTE_SHADER)
+        .setExecuteFunction([params, histogramIndex] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto hdrImage = graph.getImage(params.hdrBackbuffer);
+            auto histogramBuffer = graph.getBuffer(histogramIndex);
+
+            cmd.bindPipeline(params.histogramPipeline);
+            struct Push {
+                u64 histogramBuffer;
+                i32 hdrIndex;
+                f32 minLogLuminance;
+                f32 inverseLogLuminanceRange;
+                i32 padding;
+            };
+            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                .histogramBuffer = histogramBuffer->address(),
+                .hdrIndex = hdrImage->defaultView().index(),
+                .minLogLuminance = params.minLogLuminance,
+                .inverseLogLuminanceRange = 1.f / (params.maxLogLuminance - params.minLogLuminance)
+            });
+            cmd.dispatchThreads(hdrImage->width(), hdrImage->height());
+        });
+
+    auto exposureOutput = graph.addAlias(params.exposureBuffer);
+    graph.addPass("average_luminance", canta::PassType::COMPUTE, exposureGroup)
+        .addStorageBufferRead(histogramIndex, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.exposureBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(exposureOutput, canta::PipelineStage::COMPUTE_SHADER)
+        .setExecuteFunction([params, histogramIndex, exposureOutput] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto hdrImage = graph.getImage(params.hdrBackbuffer);
+            auto histogramBuffer = graph.getBuffer(histogramIndex);
+            auto exposureBuffer = graph.getBuffer(exposureOutput);
+
+            cmd.bindPipeline(params.averagePipeline);
+            struct Push {
+                u64 histogramBuffer;
+                u64 exposureBuffer;
+                f32 minLogLuminance;
+                f32 logLuminanceRange;
+                f32 adaptationCoefficient;
+                f32 keyValue;
+                u32 pixelCount;
+                i32 padding;
+            };
+            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                .histogramBuffer = histogramBuffer->address(),
+                .exposureBuffer = exposureBuffer->address(),
+                .minLogLuminance = params.minLogLuminance,
+                .logLuminanceRange = params.maxLogLuminance - params.minLogLuminance,
+                .adaptationCoefficient = params.adaptationCoefficient,
+                .keyValue = params.keyValue,
+                .pixelCount = hdrImage->width() * hdrImage->height()
+            });
+            cmd.dispatchWorkgroups();
+        });
+    return exposureOutput;
+}
@@ -0,0 +1,23 @@
+#ifndef CEN_EXPOSUREPASS_H
+#define CEN_EXPOSUREPASS_H
+
+#include <Canta/RenderGraph.h>
+
+namespace cen::passes {
+
+    struct AutoExposureParams {
+        canta::ImageIndex hdrBackbuffer;
+        canta::BufferIndex exposureBuffer;
+        f32 minLogLuminance;
+        f32 maxLogLuminance;
+        f32 adaptationCoefficient;
+        f32 keyValue;
+        canta::PipelineHandle histogramPipeline;
+        canta::PipelineHandle averagePipeline;
+    };
+    // builds a luminance histogram of the hdr image and adapts the exposure stored in exposureBuffer on the gpu
+    auto autoExposure(canta::RenderGraph& graph, AutoExposureParams params) -> canta::BufferIndex;
+
+}
+
+#endif //CEN_EXPOSUREPASS_H
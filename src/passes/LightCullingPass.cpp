@@ -0,0 +1,38 @@
+#include "LightCullingPass.h"
+#include <Ende/util/colour.h>
+#include <cen.glsl>
+
+auto cen::passes::cullLights(canta::RenderGraph &graph, cen::passes::LightCullingParams params) -> canta::RenderPass & {
+    auto lightGroup = graph.getGroup("light_culling", ende::util::rgb(230, 223, 92));
+
+    auto& cullLightsPass = graph.addPass("cull_lights", canta::PassType::COMPUTE, lightGroup)
+        .addStorageBufferRead(params.globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.lightBuffer, canta::PipelineStage::COMPUTE_SHADER)
+
+        .addStorageBufferWrite(params.clusterBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(params.lightIndexBuffer, canta::PipelineStage::COMPUTE_SHADER)
+
+        .setExecuteFunction([params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto globalBuffer = graph.getBuffer(params.globalBuffer);
+            auto clusterBuffer = graph.getBuffer(params.clusterBuffer);
+            auto lightIndexBuffer = graph.getBuffer(params.lightIndexBuffer);
+
+            cmd.bindPipeline(params.cullLightsPipeline);
+            struct Push {
+                u64 globalDataRef;
+                u64 clusterBuffer;
+                u64 lightIndexBuffer;
+                i32 cameraIndex;
+                i32 padding;
+            };
+            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                .globalDataRef = globalBuffer->address(),
+                .clusterBuffer = clusterBuffer->address(),
+                .lightIndexBuffer = lightIndexBuffer->address(),
+                .cameraIndex = params.cameraIndex
+            });
+            cmd.dispatchThreads(params.clusterCount);
+        });
+    return cullLightsPass;
+}
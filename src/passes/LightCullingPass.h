@@ -0,0 +1,22 @@
+#ifndef CEN_LIGHTCULLINGPASS_H
+#define CEN_LIGHTCULLINGPASS_H
+
+#include <Canta/RenderGraph.h>
+
+namespace cen::passes {
+
+    struct LightCullingParams {
+        canta::BufferIndex globalBuffer;
+        canta::BufferIndex cameraBuffer;
+        canta::BufferIndex lightBuffer;
+        canta::BufferIndex clusterBuffer;
+        canta::BufferIndex lightIndexBuffer;
+        i32 cameraIndex;
+        u32 clusterCount;
+        canta::PipelineHandle cullLightsPipeline;
+    };
+    auto cullLights(canta::RenderGraph& graph, LightCullingParams params) -> canta::RenderPass&;
+
+}
+
+#endif //CEN_LIGHTCULLINGPASS_H
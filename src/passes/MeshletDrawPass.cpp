@@ -19,38 +19,66 @@ auto cen::passes::drawMeshlets(canta::RenderGraph& graph, cen::passes::DrawMeshl
             .addStorageBufferRead(params.transformBuffer, canta::PipelineStage::MESH_SHADER)
             .addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::MESH_SHADER)
 
-            .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::MESH_SHADER)
-            .addColourWrite(params.backbufferImage, std::to_array({ MAX_MESHLET_INSTANCE, 0, 0, 0 }))
-            .addDepthWrite(params.depthImage, canta::DepthClearValue{ 0, 0 })
-
-            .setExecuteFunction([params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
-                auto command = graph.getBuffer(params.command);
-                auto globalBuffer = graph.getBuffer(params.globalBuffer);
-                auto meshletInstanceBuffer = graph.getBuffer(params.meshletInstanceBuffer);
-
-                cmd.bindPipeline(params.meshShadingPipeline);
-                cmd.setViewport({ 1920, 1080 });
-                struct Push {
-                    u64 globalDataRef;
-                    u64 meshletInstanceBuffer;
-                    i32 alphaPass;
-                    i32 padding;
-                };
-                cmd.pushConstants(canta::ShaderStage::MESH | canta::ShaderStage::FRAGMENT, Push {
-                    .globalDataRef = globalBuffer->address(),
-                    .meshletInstanceBuffer = meshletInstanceBuffer->address(),
-                    .alphaPass = 0
-                });
-                cmd.drawMeshTasksIndirect(command, 0, 1);
+            .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::MESH_SHADER);
+
+        if (params.taskShading) {
+            geometryPass.addStorageBufferRead(params.globalBuffer, canta::PipelineStage::TASK_SHADER);
+            geometryPass.addStorageBufferRead(params.meshletBuffer, canta::PipelineStage::TASK_SHADER);
+            geometryPass.addStorageBufferRead(params.meshletInstanceBuffer, canta::PipelineStage::TASK_SHADER);
+            geometryPass.addStorageBufferRead(params.transformBuffer, canta::PipelineStage::TASK_SHADER);
+            geometryPass.addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::TASK_SHADER);
+            geometryPass.addStorageBufferRead(params.cullingViewBuffer, canta::PipelineStage::TASK_SHADER);
+            geometryPass.addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::TASK_SHADER);
+        }
+
+        if (!params.depthOnly)
+            geometryPass.addColourWrite(params.backbufferImage, std::to_array<u32>({ MESHLET_CLEAR_ID, 0, 0, 0 }));
+        if (params.depthInput.id > -1)
+            geometryPass.addDepthRead(params.depthInput);
+        if (params.clearDepth)
+            geometryPass.addDepthWrite(params.depthImage, canta::DepthClearValue{ 0, 0 });
+        else
+            geometryPass.addDepthWrite(params.depthImage);
+
+        geometryPass.setExecuteFunction([params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto command = graph.getBuffer(params.command);
+            auto globalBuffer = graph.getBuffer(params.globalBuffer);
+            auto meshletInstanceBuffer = graph.getBuffer(params.meshletInstanceBuffer);
 
-                cmd.bindPipeline(params.meshShadingAlphaPipeline);
-                cmd.pushConstants(canta::ShaderStage::MESH | canta::ShaderStage::FRAGMENT, Push {
-                    .globalDataRef = globalBuffer->address(),
-                    .meshletInstanceBuffer = meshletInstanceBuffer->address(),
-                    .alphaPass = 1
-                });
-                cmd.drawMeshTasksIndirect(command, sizeof(DispatchIndirectCommand), 1);
+            auto stages = canta::ShaderStage::MESH | canta::ShaderStage::FRAGMENT;
+            if (params.taskShading)
+                stages = stages | canta::ShaderStage::TASK;
+            const i32 cullingCameraIndex = params.cullingCameraIndex < 0 ? params.cameraIndex : params.cullingCameraIndex;
+
+            cmd.bindPipeline(params.meshShadingPipeline);
+            cmd.setViewport(params.viewportSize, params.viewportOffset);
+            struct Push {
+                u64 globalDataRef;
+                u64 meshletInstanceBuffer;
+                i32 alphaPass;
+                i32 cameraIndex;
+                i32 cullingCameraIndex;
+                i32 padding;
+            };
+            cmd.pushConstants(stages, Push {
+                .globalDataRef = globalBuffer->address(),
+                .meshletInstanceBuffer = meshletInstanceBuffer->address() + params.meshletInstanceOffset,
+                .alphaPass = 0,
+                .cameraIndex = params.cameraIndex,
+                .cullingCameraIndex = cullingCameraIndex
+            });
+            cmd.drawMeshTasksIndirect(command, params.commandOffset, 1);
+
+            cmd.bindPipeline(params.meshShadingAlphaPipeline);
+            cmd.pushConstants(stages, Push {
+                .globalDataRef = globalBuffer->address(),
+                .meshletInstanceBuffer = meshletInstanceBuffer->address() + params.meshletInstanceOffset,
+                .alphaPass = 1,
+                .cameraIndex = params.cameraIndex,
+                .cullingCameraIndex = cullingCameraIndex
             });
+            cmd.drawMeshTasksIndirect(command, params.commandOffset + sizeof(DispatchIndirectCommand), 1);
+        });
         return geometryPass;
     } else {
 
@@ -110,14 +138,17 @@ auto cen::passes::drawMeshlets(canta::RenderGraph& graph, cen::passes::DrawMeshl
                 u64 meshletInstanceBuffer;
                 u64 outputIndexBuffer;
                 u64 drawCommandsBuffer;
+                i32 cameraIndex;
+                i32 padding;
             };
             cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
                     .globalDataRef = globalBuffer->address(),
-                    .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+                    .meshletInstanceBuffer = meshletInstanceBuffer->address() + params.meshletInstanceOffset,
                     .outputIndexBuffer = outputIndexBuffer->address(),
-                    .drawCommandsBuffer = drawCommandsBuffer->address()
+                    .drawCommandsBuffer = drawCommandsBuffer->address(),
+                    .cameraIndex = params.cameraIndex
             });
-            cmd.dispatchIndirect(command, 0);
+            cmd.dispatchIndirect(command, params.commandOffset);
         });
 
         auto& geometryPass = graph.addPass("geometry", canta::PassType::GRAPHICS, drawGroup);
@@ -132,8 +163,14 @@ auto cen::passes::drawMeshlets(canta::RenderGraph& graph, cen::passes::DrawMeshl
         geometryPass.addStorageBufferRead(params.transformBuffer, canta::PipelineStage::VERTEX_SHADER);
         geometryPass.addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::VERTEX_SHADER);
 
-        geometryPass.addColourWrite(params.backbufferImage, std::to_array({ MAX_MESHLET_INSTANCE, 0, 0, 0 }));
-        geometryPass.addDepthWrite(params.depthImage, canta::DepthClearValue{ 0, 0 });
+        if (!params.depthOnly)
+            geometryPass.addColourWrite(params.backbufferImage, std::to_array<u32>({ MESHLET_CLEAR_ID, 0, 0, 0 }));
+        if (params.depthInput.id > -1)
+            geometryPass.addDepthRead(params.depthInput);
+        if (params.clearDepth)
+            geometryPass.addDepthWrite(params.depthImage, canta::DepthClearValue{ 0, 0 });
+        else
+            geometryPass.addDepthWrite(params.depthImage);
 
         geometryPass.setExecuteFunction([params, outputIndicesIndex, drawCommandsIndex] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
             auto globalBuffer = graph.getBuffer(params.globalBuffer);
@@ -142,16 +179,19 @@ auto cen::passes::drawMeshlets(canta::RenderGraph& graph, cen::passes::DrawMeshl
             auto drawCommandsBuffer = graph.getBuffer(drawCommandsIndex);
 
             cmd.bindPipeline(params.vertexPipeline);
-            cmd.setViewport({ 1920, 1080 });
+            cmd.setViewport(params.viewportSize, params.viewportOffset);
             struct Push {
                 u64 globalDataRef;
                 u64 meshletInstanceBuffer;
                 u64 meshletIndexBuffer;
+                i32 cameraIndex;
+                i32 padding;
             };
             cmd.pushConstants(canta::ShaderStage::VERTEX, Push {
                     .globalDataRef = globalBuffer->address(),
-                    .meshletInstanceBuffer = meshletInstanceBuffer->address(),
-                    .meshletIndexBuffer = meshletIndexBuffer->address()
+                    .meshletInstanceBuffer = meshletInstanceBuffer->address() + params.meshletInstanceOffset,
+                    .meshletIndexBuffer = meshletIndexBuffer->address(),
+                    .cameraIndex = params.cameraIndex
             });
             cmd.drawIndirectCount(drawCommandsBuffer, sizeof(u32), drawCommandsBuffer, 0);
         });
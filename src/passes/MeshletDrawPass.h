@@ -2,6 +2,7 @@
 #define CEN_MESHLETDRAWPASS_H
 
 #include <Canta/RenderGraph.h>
+#include <Ende/math/Vec.h>
 
 namespace cen::passes {
 
@@ -13,12 +14,26 @@ namespace cen::passes {
         canta::BufferIndex primitiveBuffer;
         canta::BufferIndex meshletBuffer;
         canta::BufferIndex meshletInstanceBuffer;
+        // byte offsets of this view's instances and commands, used when drawing from a multi view culling output
+        u32 meshletInstanceOffset = 0;
+        u32 commandOffset = 0;
         canta::BufferIndex transformBuffer;
         canta::BufferIndex cameraBuffer;
+        canta::BufferIndex cullingViewBuffer;
         canta::BufferIndex feedbackBuffer;
         canta::ImageIndex backbufferImage;
         canta::ImageIndex depthImage;
+        // earlier version of depthImage when several draws write one depth image, orders this draw after them
+        canta::ImageIndex depthInput = {};
+        i32 cameraIndex;
+        i32 cullingCameraIndex = -1; // defaults to cameraIndex
+        bool depthOnly = false;
+        bool clearDepth = true;
+        ende::math::Vec<2, f32> viewportSize = { 1920, 1080 };
+        ende::math::Vec<2, f32> viewportOffset = { 0, 0 };
         bool useMeshShading = true;
+        // meshShadingPipeline has a task stage that culls the meshlets of the culled meshes itself
+        bool taskShading = false;
         canta::PipelineHandle meshShadingPipeline;
         canta::PipelineHandle meshShadingAlphaPipeline;
         canta::PipelineHandle writePrimitivesPipeline;
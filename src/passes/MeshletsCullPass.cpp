@@ -1,148 +1,392 @@
 #include "MeshletsCullPass.h"
 #include <cen.glsl>
 #include <Ende/util/colour.h>
+#include <algorithm>
+
+namespace {
+
+    // opaque and alpha counters followed by the finished workgroup counters, see mesh_range.glsl
+    constexpr u32 MESH_RANGE_HEADER_SIZE = sizeof(u64) * 2 + sizeof(u32) * 4;
+
+    auto meshRangeBufferSize(u32 meshCount) -> u32 {
+        return static_cast<u32>(MESH_RANGE_HEADER_SIZE + sizeof(MeshRange) * std::max(meshCount, 1u));
+    }
+
+    // writes one meshlet instance per thread by searching the culled mesh ranges, so the cost no longer depends on
+    // the meshlet count of the largest mesh. cullCommandResource is written by the last workgroup of mesh culling
+    template <typename Group>
+    void expandMeshRanges(canta::RenderGraph& graph, Group group, canta::BufferIndex globalBuffer, canta::BufferIndex meshBuffer,
+                          canta::BufferIndex meshRangeResource, canta::BufferIndex cullCommandResource, canta::BufferIndex outputInstanceResource,
+                          u32 rangeCapacity, canta::PipelineHandle expandMeshesPipeline) {
+        graph.addPass("expand_meshes", canta::PassType::COMPUTE, group)
+            .addIndirectRead(cullCommandResource)
+            .addStorageBufferRead(globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(meshBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(meshRangeResource, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferWrite(outputInstanceResource, canta::PipelineStage::COMPUTE_SHADER)
+
+            .setExecuteFunction([globalBuffer, meshRangeResource, outputInstanceResource, cullCommandResource, rangeCapacity, expandMeshesPipeline] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+                auto global = graph.getBuffer(globalBuffer);
+                auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
+                auto meshletInstanceBuffer = graph.getBuffer(outputInstanceResource);
+                auto commandBuffer = graph.getBuffer(cullCommandResource);
+
+                cmd.bindPipeline(expandMeshesPipeline);
+                struct Push {
+                    u64 globalDataRef;
+                    u64 meshRangeBuffer;
+                    u64 meshletInstanceBuffer;
+                    u32 rangeCapacity;
+                    i32 alpha;
+                };
+                cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                    .globalDataRef = global->address(),
+                    .meshRangeBuffer = meshRangeBuffer->address(),
+                    .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+                    .rangeCapacity = rangeCapacity,
+                    .alpha = false
+                });
+                cmd.dispatchIndirect(commandBuffer, 0);
+                cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                    .globalDataRef = global->address(),
+                    .meshRangeBuffer = meshRangeBuffer->address(),
+                    .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+                    .rangeCapacity = rangeCapacity,
+                    .alpha = true
+                });
+                cmd.dispatchIndirect(commandBuffer, sizeof(DispatchIndirectCommand));
+            });
+    }
+
+}
 
 auto cen::passes::cullMeshlets(canta::RenderGraph &graph, cen::passes::CullMeshletsParams params) -> canta::RenderPass& {
     auto cullGroup = graph.getGroup(params.name, ende::util::rgb(7, 91, 79));
 
-    auto meshOutputInstanceResource = graph.addBuffer({
-        .size = static_cast<u32>((sizeof(u32) * 2) + sizeof(MeshletInstance) * params.maxMeshletInstancesCount),
-        .name = "mesh_output_instances"
+    auto meshRangeResource = graph.addBuffer({
+        .size = meshRangeBufferSize(params.meshCount),
+        .name = "mesh_ranges"
+    });
+    // expand_meshes and cull_meshlets both run one thread per meshlet instance so they share their dispatch
+    auto cullCommandResource = graph.addBuffer({
+        .size = sizeof(DispatchIndirectCommand) * 2,
+        .name = "cull_command"
     });
 
-    auto meshCommandResource = graph.addAlias(params.outputCommand);
+    // with task shading the mesh level output is what gets drawn, so there is no intermediate buffer
+    auto meshOutputInstanceResource = params.meshletInstanceBuffer;
+    if (!params.taskShading) {
+        meshOutputInstanceResource = graph.addBuffer({
+            .size = static_cast<u32>((sizeof(u32) * 2) + sizeof(MeshletInstance) * params.maxMeshletInstancesCount),
+            .name = "mesh_output_instances"
+        });
+    }
+
+    // the mesh level instance header is written by the last workgroup of cull_meshes so only the ranges need clearing
     auto& clearMeshPass = graph.addPass("clear_mesh", canta::PassType::TRANSFER, cullGroup)
-        .addTransferWrite(meshOutputInstanceResource)
-        .addTransferWrite(params.meshletInstanceBuffer)
-        .setExecuteFunction([meshOutputInstanceResource, params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
-            auto meshletInstanceBuffer = graph.getBuffer(meshOutputInstanceResource);
-            auto meshletInstanceBuffer2 = graph.getBuffer(params.meshletInstanceBuffer);
+        .addTransferWrite(meshRangeResource);
+    if (!params.taskShading)
+        clearMeshPass.addTransferWrite(params.meshletInstanceBuffer);
+    clearMeshPass.setExecuteFunction([meshRangeResource, params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+        auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
+        cmd.clearBuffer(meshRangeBuffer, 0, 0, MESH_RANGE_HEADER_SIZE);
+        if (!params.taskShading) {
+            auto meshletInstanceBuffer = graph.getBuffer(params.meshletInstanceBuffer);
             cmd.clearBuffer(meshletInstanceBuffer, 0, 0, sizeof(u32) * 2);
-            cmd.clearBuffer(meshletInstanceBuffer2, 0, 0, sizeof(u32) * 2);
-        });
+        }
+    });
     if (params.read)
         clearMeshPass.addStorageImageRead(params.read.value(), canta::PipelineStage::COMPUTE_SHADER);
 
-    auto [ meshCullingOutputClear, meshletCullingOutputClear ] = clearMeshPass.aliasBufferOutputs<2>();
+    canta::BufferIndex meshCullingOutputClear = {};
+    canta::BufferIndex meshletCullingOutputClear = {};
+    if (params.taskShading) {
+        auto [ outputClear ] = clearMeshPass.aliasBufferOutputs<1>();
+        meshCullingOutputClear = outputClear;
+    } else {
+        auto [ meshOutputClear, meshletOutputClear ] = clearMeshPass.aliasBufferOutputs<2>();
+        meshCullingOutputClear = meshOutputClear;
+        meshletCullingOutputClear = meshletOutputClear;
+    }
 
 
-    graph.addPass("cull_meshes", canta::PassType::COMPUTE, cullGroup)
+    auto& cullMeshesPass = graph.addPass("cull_meshes", canta::PassType::COMPUTE, cullGroup)
         .addStorageBufferRead(meshCullingOutputClear, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(params.meshBuffer, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(params.transformBuffer, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.cullingViewBuffer, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(params.globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
 
+        .addStorageBufferWrite(meshRangeResource, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferWrite(meshOutputInstanceResource, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(cullCommandResource, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::COMPUTE_SHADER);
+    if (params.taskShading)
+        cullMeshesPass.addStorageBufferWrite(params.outputCommand, canta::PipelineStage::COMPUTE_SHADER);
+
+    cullMeshesPass.setExecuteFunction([meshRangeResource, meshOutputInstanceResource, cullCommandResource, params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+        auto globalBuffer = graph.getBuffer(params.globalBuffer);
+        auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
+        auto meshletInstanceBuffer = graph.getBuffer(meshOutputInstanceResource);
+        auto commandBuffer = graph.getBuffer(cullCommandResource);
+
+        cmd.bindPipeline(params.cullMeshesPipeline);
+        struct Push {
+            u64 globalDataRef;
+            u64 meshRangeBuffer;
+            u64 meshletInstanceBuffer;
+            u64 commandBuffer;
+            u64 drawCommandBuffer;
+            i32 cameraIndex;
+            i32 testAlpha;
+            u32 meshCount;
+        };
+        cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+            .globalDataRef = globalBuffer->address(),
+            .meshRangeBuffer = meshRangeBuffer->address(),
+            .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+            .commandBuffer = commandBuffer->address(),
+            .drawCommandBuffer = params.taskShading ? graph.getBuffer(params.outputCommand)->address() : 0,
+            .cameraIndex = params.cameraIndex,
+            .testAlpha = params.testAlpha,
+            .meshCount = params.meshCount
+        });
+        // at least one workgroup has to run for the commands to be written
+        cmd.dispatchThreads(std::max(params.meshCount, 1u));
+    });
+
+    expandMeshRanges(graph, cullGroup, params.globalBuffer, params.meshBuffer, meshRangeResource, cullCommandResource,
+                     meshOutputInstanceResource, params.meshCount, params.expandMeshesPipeline);
+
+    if (!params.taskShading) {
+        canta::BufferIndex softwareMeshletClear = {};
+        if (params.softwareMeshletBuffer) {
+            auto softwareMeshletBuffer = params.softwareMeshletBuffer.value();
+            auto [ softwareClear ] = graph.addPass("clear_software_meshlets", canta::PassType::TRANSFER, cullGroup)
+                .addTransferWrite(softwareMeshletBuffer)
+                .setExecuteFunction([softwareMeshletBuffer] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+                    cmd.clearBuffer(graph.getBuffer(softwareMeshletBuffer), 0, 0, sizeof(u32) * 2);
+                })
+                .aliasBufferOutputs<1>();
+            softwareMeshletClear = softwareClear;
+        }
 
-        .setExecuteFunction([meshOutputInstanceResource, params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+        auto& cullMeshletsPass = graph.addPass("cull_meshlets", canta::PassType::COMPUTE, cullGroup)
+
+            .addIndirectRead(cullCommandResource)
+            .addStorageBufferRead(params.globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(meshletCullingOutputClear, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(params.transformBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(params.meshletBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(params.cullingViewBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferRead(meshOutputInstanceResource, canta::PipelineStage::COMPUTE_SHADER)
+
+            .addStorageBufferWrite(params.meshletInstanceBuffer, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferWrite(meshRangeResource, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferWrite(params.outputCommand, canta::PipelineStage::COMPUTE_SHADER)
+            .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::COMPUTE_SHADER);
+        if (params.softwareMeshletBuffer) {
+            cullMeshletsPass.addStorageBufferRead(softwareMeshletClear, canta::PipelineStage::COMPUTE_SHADER);
+            cullMeshletsPass.addStorageBufferWrite(params.softwareMeshletBuffer.value(), canta::PipelineStage::COMPUTE_SHADER);
+            cullMeshletsPass.addStorageBufferWrite(params.softwareCommand, canta::PipelineStage::COMPUTE_SHADER);
+        }
+
+        cullMeshletsPass.setExecuteFunction([params, cullCommandResource, meshOutputInstanceResource, meshRangeResource] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
             auto globalBuffer = graph.getBuffer(params.globalBuffer);
-            auto meshletInstanceBuffer = graph.getBuffer(meshOutputInstanceResource);
+            auto cullCommandBuffer = graph.getBuffer(cullCommandResource);
+            auto meshletInstanceInputBuffer = graph.getBuffer(meshOutputInstanceResource);
+            auto meshletInstanceOutputBuffer = graph.getBuffer(params.meshletInstanceBuffer);
+            auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
+            auto drawCommandBuffer = graph.getBuffer(params.outputCommand);
+            const u64 softwareMeshletAddress = params.softwareMeshletBuffer ? graph.getBuffer(params.softwareMeshletBuffer.value())->address() : 0;
+            const u64 softwareCommandAddress = params.softwareMeshletBuffer ? graph.getBuffer(params.softwareCommand)->address() : 0;
 
-            cmd.bindPipeline(params.cullMeshesPipeline);
+            cmd.bindPipeline(params.culLMeshletsPipeline);
             struct Push {
                 u64 globalDataRef;
-                u64 meshletInstanceBuffer;
+                u64 meshletInstanceInputBuffer;
+                u64 meshletInstanceOutputBuffer;
+                u64 meshRangeBuffer;
+                u64 commandBuffer;
+                u64 softwareMeshletBuffer;
+                u64 softwareCommandBuffer;
                 i32 cameraIndex;
-                i32 testAlpha;
+                i32 alpha;
+                f32 softwareThreshold;
+                i32 padding;
             };
             cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
                 .globalDataRef = globalBuffer->address(),
-                .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+                .meshletInstanceInputBuffer = meshletInstanceInputBuffer->address(),
+                .meshletInstanceOutputBuffer = meshletInstanceOutputBuffer->address(),
+                .meshRangeBuffer = meshRangeBuffer->address(),
+                .commandBuffer = drawCommandBuffer->address(),
+                .softwareMeshletBuffer = softwareMeshletAddress,
+                .softwareCommandBuffer = softwareCommandAddress,
+                .cameraIndex = params.cameraIndex,
+                .alpha = false,
+                .softwareThreshold = params.softwareThreshold
+            });
+            cmd.dispatchIndirect(cullCommandBuffer, 0);
+            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                .globalDataRef = globalBuffer->address(),
+                .meshletInstanceInputBuffer = meshletInstanceInputBuffer->address(),
+                .meshletInstanceOutputBuffer = meshletInstanceOutputBuffer->address(),
+                .meshRangeBuffer = meshRangeBuffer->address(),
+                .commandBuffer = drawCommandBuffer->address(),
+                .softwareMeshletBuffer = softwareMeshletAddress,
+                .softwareCommandBuffer = softwareCommandAddress,
                 .cameraIndex = params.cameraIndex,
-                .testAlpha = params.testAlpha
+                .alpha = true,
+                .softwareThreshold = params.softwareThreshold
             });
-            cmd.dispatchThreads(params.meshCount);
+            cmd.dispatchIndirect(cullCommandBuffer, sizeof(DispatchIndirectCommand));
         });
+    }
 
-    graph.addPass("write_mesh_command", canta::PassType::COMPUTE, cullGroup)
-        .addStorageBufferRead(meshOutputInstanceResource, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageBufferWrite(meshCommandResource, canta::PipelineStage::COMPUTE_SHADER)
+    return clearMeshPass;
+}
+
+auto cen::passes::meshletInstanceBufferSize(u32 maxMeshletInstancesCount) -> u32 {
+    return static_cast<u32>((sizeof(u32) * 2) + sizeof(MeshletInstance) * maxMeshletInstancesCount);
+}
 
-        .setExecuteFunction([params, meshOutputInstanceResource, meshCommandResource] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+auto cen::passes::cullMeshletsMultiView(canta::RenderGraph &graph, cen::passes::CullMeshletsMultiViewParams params) -> canta::RenderPass& {
+    auto cullGroup = graph.getGroup(params.name, ende::util::rgb(7, 91, 79));
+    assert(params.viewCount > 0 && params.viewCount <= MAX_CULLING_VIEWS);
+
+    const u32 viewStride = meshletInstanceBufferSize(params.maxMeshletInstancesCount);
+
+    auto meshRangeResource = graph.addBuffer({
+        .size = meshRangeBufferSize(params.meshCount),
+        .name = "mesh_ranges_multi_view"
+    });
+    auto cullCommandResource = graph.addBuffer({
+        .size = sizeof(DispatchIndirectCommand) * 2,
+        .name = "cull_command_multi_view"
+    });
+    auto meshOutputInstanceResource = graph.addBuffer({
+        .size = static_cast<u32>((sizeof(u32) * 2) + sizeof(MultiViewMeshletInstance) * params.maxMeshletInstancesCount),
+        .name = "mesh_output_instances_multi_view"
+    });
+
+    auto& clearMeshPass = graph.addPass("clear_mesh", canta::PassType::TRANSFER, cullGroup)
+        .addTransferWrite(meshRangeResource)
+        .addTransferWrite(params.meshletInstanceBuffer)
+        .setExecuteFunction([meshRangeResource, params, viewStride] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
+            auto meshletInstanceBuffer = graph.getBuffer(params.meshletInstanceBuffer);
+            cmd.clearBuffer(meshRangeBuffer, 0, 0, MESH_RANGE_HEADER_SIZE);
+            for (u32 view = 0; view < params.viewCount; view++)
+                cmd.clearBuffer(meshletInstanceBuffer, 0, view * viewStride, sizeof(u32) * 2);
+        });
+
+    auto [ meshCullingOutputClear, meshletCullingOutputClear ] = clearMeshPass.aliasBufferOutputs<2>();
+
+
+    graph.addPass("cull_meshes", canta::PassType::COMPUTE, cullGroup)
+        .addStorageBufferRead(meshCullingOutputClear, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.meshBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.transformBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.cullingViewBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
+
+        .addStorageBufferWrite(meshRangeResource, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(meshOutputInstanceResource, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(cullCommandResource, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::COMPUTE_SHADER)
+
+        .setExecuteFunction([meshRangeResource, meshOutputInstanceResource, cullCommandResource, params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto globalBuffer = graph.getBuffer(params.globalBuffer);
+            auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
             auto meshletInstanceBuffer = graph.getBuffer(meshOutputInstanceResource);
-            auto meshletCommandBuffer = graph.getBuffer(meshCommandResource);
+            auto commandBuffer = graph.getBuffer(cullCommandResource);
 
-            cmd.bindPipeline(params.writeMeshletCullCommandPipeline);
+            cmd.bindPipeline(params.cullMeshesPipeline);
             struct Push {
+                u64 globalDataRef;
+                u64 meshRangeBuffer;
                 u64 meshletInstanceBuffer;
                 u64 commandBuffer;
+                i32 firstCameraIndex;
+                u32 viewCount;
+                u32 meshCount;
             };
             cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                .globalDataRef = globalBuffer->address(),
+                .meshRangeBuffer = meshRangeBuffer->address(),
                 .meshletInstanceBuffer = meshletInstanceBuffer->address(),
-                .commandBuffer = meshletCommandBuffer->address()
+                .commandBuffer = commandBuffer->address(),
+                .firstCameraIndex = params.firstCameraIndex,
+                .viewCount = params.viewCount,
+                .meshCount = params.meshCount
             });
-            cmd.dispatchWorkgroups();
+            cmd.dispatchThreads(std::max(params.meshCount, 1u));
         });
 
-
+    expandMeshRanges(graph, cullGroup, params.globalBuffer, params.meshBuffer, meshRangeResource, cullCommandResource,
+                     meshOutputInstanceResource, params.meshCount, params.expandMeshesPipeline);
 
     graph.addPass("cull_meshlets", canta::PassType::COMPUTE, cullGroup)
 
-        .addIndirectRead(meshCommandResource)
+        .addIndirectRead(cullCommandResource)
         .addStorageBufferRead(params.globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(meshletCullingOutputClear, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(params.transformBuffer, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(params.meshletBuffer, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.cullingViewBuffer, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferRead(meshOutputInstanceResource, canta::PipelineStage::COMPUTE_SHADER)
 
         .addStorageBufferWrite(params.meshletInstanceBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(meshRangeResource, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(params.outputCommand, canta::PipelineStage::COMPUTE_SHADER)
         .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::COMPUTE_SHADER)
 
-        .setExecuteFunction([params, meshCommandResource, meshOutputInstanceResource] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+        .setExecuteFunction([params, cullCommandResource, meshOutputInstanceResource, meshRangeResource, viewStride] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
             auto globalBuffer = graph.getBuffer(params.globalBuffer);
-            auto meshCommandBuffer = graph.getBuffer(meshCommandResource);
+            auto cullCommandBuffer = graph.getBuffer(cullCommandResource);
             auto meshletInstanceInputBuffer = graph.getBuffer(meshOutputInstanceResource);
             auto meshletInstanceOutputBuffer = graph.getBuffer(params.meshletInstanceBuffer);
+            auto meshRangeBuffer = graph.getBuffer(meshRangeResource);
+            auto drawCommandBuffer = graph.getBuffer(params.outputCommand);
 
-            cmd.bindPipeline(params.culLMeshletsPipeline);
+            cmd.bindPipeline(params.cullMeshletsPipeline);
             struct Push {
                 u64 globalDataRef;
                 u64 meshletInstanceInputBuffer;
                 u64 meshletInstanceOutputBuffer;
-                i32 cameraIndex;
+                u64 meshRangeBuffer;
+                u64 commandBuffer;
+                i32 firstCameraIndex;
+                u32 viewCount;
+                u32 outputStride;
                 i32 alpha;
             };
             cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
                 .globalDataRef = globalBuffer->address(),
                 .meshletInstanceInputBuffer = meshletInstanceInputBuffer->address(),
                 .meshletInstanceOutputBuffer = meshletInstanceOutputBuffer->address(),
-                .cameraIndex = params.cameraIndex,
+                .meshRangeBuffer = meshRangeBuffer->address(),
+                .commandBuffer = drawCommandBuffer->address(),
+                .firstCameraIndex = params.firstCameraIndex,
+                .viewCount = params.viewCount,
+                .outputStride = viewStride,
                 .alpha = false
             });
-            cmd.dispatchIndirect(meshCommandBuffer, 0);
+            cmd.dispatchIndirect(cullCommandBuffer, 0);
             cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
                 .globalDataRef = globalBuffer->address(),
                 .meshletInstanceInputBuffer = meshletInstanceInputBuffer->address(),
                 .meshletInstanceOutputBuffer = meshletInstanceOutputBuffer->address(),
-                .cameraIndex = params.cameraIndex,
+                .meshRangeBuffer = meshRangeBuffer->address(),
+                .commandBuffer = drawCommandBuffer->address(),
+                .firstCameraIndex = params.firstCameraIndex,
+                .viewCount = params.viewCount,
+                .outputStride = viewStride,
                 .alpha = true
             });
-            cmd.dispatchIndirect(meshCommandBuffer, sizeof(DispatchIndirectCommand));
-        });
-
-    graph.addPass("write_meshlet_command", canta::PassType::COMPUTE, cullGroup)
-
-        .addStorageBufferRead(params.meshletInstanceBuffer, canta::PipelineStage::COMPUTE_SHADER)
-        .addStorageBufferWrite(params.outputCommand, canta::PipelineStage::COMPUTE_SHADER)
-
-        .setExecuteFunction([params] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
-            auto meshletInstanceBuffer = graph.getBuffer(params.meshletInstanceBuffer);
-            auto meshletCommandBuffer = graph.getBuffer(params.outputCommand);
-
-            cmd.bindPipeline(params.writeMeshletDrawCommandPipeline);
-            struct Push {
-                u64 meshletInstanceBuffer;
-                u64 commandBuffer;
-            };
-            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
-                .meshletInstanceBuffer = meshletInstanceBuffer->address(),
-                .commandBuffer = meshletCommandBuffer->address()
-            });
-            cmd.dispatchWorkgroups();
+            cmd.dispatchIndirect(cullCommandBuffer, sizeof(DispatchIndirectCommand));
         });
 
     return clearMeshPass;
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #define CEN_MESHLETSCULLPASS_H
 
 #include <Canta/RenderGraph.h>
+#include <optional>
 
 namespace cen::passes {
 
@@ -11,23 +12,56 @@ namespace cen::passes {
         canta::BufferIndex meshletBuffer;
         canta::BufferIndex meshletInstanceBuffer;
         canta::BufferIndex transformBuffer;
-        canta::BufferIndex cameraBuffer;
+        canta::BufferIndex cullingViewBuffer;
         canta::BufferIndex feedbackBuffer;
         canta::BufferIndex outputCommand;
         u32 maxMeshletInstancesCount;
         u32 meshCount;
         i32 cameraIndex;
         bool testAlpha;
+        // meshlets are culled by the task shader, so only the mesh level culling runs here and
+        // outputCommand receives task workgroup counts
+        bool taskShading = false;
+        // opaque meshlets projecting to fewer than softwareThreshold pixels are appended to softwareMeshletBuffer
+        // instead of the draw, and softwareCommand gets one workgroup per meshlet. not available with task shading
+        std::optional<canta::BufferIndex> softwareMeshletBuffer = {};
+        canta::BufferIndex softwareCommand = {};
+        f32 softwareThreshold = 0;
         canta::PipelineHandle cullMeshesPipeline;
-        canta::PipelineHandle writeMeshletCullCommandPipeline;
+        canta::PipelineHandle expandMeshesPipeline;
         canta::PipelineHandle culLMeshletsPipeline;
-        canta::PipelineHandle writeMeshletDrawCommandPipeline;
         std::string_view name;
         std::optional<canta::ImageIndex> read = {};
     };
 
     auto cullMeshlets(canta::RenderGraph& graph, CullMeshletsParams params) -> canta::RenderPass&;
 
+    // culls against viewCount contiguous culling views starting at firstCameraIndex. meshletInstanceBuffer holds
+    // one MeshletInstanceBuffer per view, each meshletInstanceBufferSize() bytes apart, and outputCommand holds an
+    // opaque and alpha draw command per view.
+    struct CullMeshletsMultiViewParams {
+        canta::BufferIndex globalBuffer;
+        canta::BufferIndex meshBuffer;
+        canta::BufferIndex meshletBuffer;
+        canta::BufferIndex meshletInstanceBuffer;
+        canta::BufferIndex transformBuffer;
+        canta::BufferIndex cullingViewBuffer;
+        canta::BufferIndex feedbackBuffer;
+        canta::BufferIndex outputCommand;
+        u32 maxMeshletInstancesCount;
+        u32 meshCount;
+        i32 firstCameraIndex;
+        u32 viewCount;
+        canta::PipelineHandle cullMeshesPipeline;
+        canta::PipelineHandle expandMeshesPipeline;
+        canta::PipelineHandle cullMeshletsPipeline;
+        std::string_view name;
+    };
+
+    auto meshletInstanceBufferSize(u32 maxMeshletInstancesCount) -> u32;
+
+    auto cullMeshletsMultiView(canta::RenderGraph& graph, CullMeshletsMultiViewParams params) -> canta::RenderPass&;
+
 }
 
 #endif //CEN_MESHLETSCULLPASS_H
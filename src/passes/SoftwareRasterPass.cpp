@@ -0,0 +1,89 @@
+#include "SoftwareRasterPass.h"
+#include <Ende/util/colour.h>
+#include <cen.glsl>
+
+auto cen::passes::rasteriseMeshlets(canta::RenderGraph &graph, cen::passes::RasteriseMeshletsParams params) -> canta::RenderPass & {
+    auto rasterGroup = graph.getGroup(params.name, ende::util::rgb(120, 30, 140));
+
+    auto visibilityBufferIndex = graph.addBuffer({
+        .size = static_cast<u32>(params.width * params.height * sizeof(u64)),
+        .name = "software_visibility_buffer"
+    });
+    auto visibilityBufferClear = graph.addAlias(visibilityBufferIndex);
+
+    graph.addPass("clear_software_visibility", canta::PassType::TRANSFER, rasterGroup)
+        .addTransferWrite(visibilityBufferClear)
+        .setExecuteFunction([visibilityBufferClear] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto visibilityBuffer = graph.getBuffer(visibilityBufferClear);
+            cmd.clearBuffer(visibilityBuffer);
+        });
+
+    graph.addPass("rasterise", canta::PassType::COMPUTE, rasterGroup)
+        .addIndirectRead(params.command)
+
+        .addStorageBufferRead(params.globalBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.vertexBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.indexBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.primitiveBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.meshletBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.transformBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.cameraBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(params.softwareMeshletBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferRead(visibilityBufferClear, canta::PipelineStage::COMPUTE_SHADER)
+
+        .addStorageBufferWrite(params.meshletInstanceBuffer, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(visibilityBufferIndex, canta::PipelineStage::COMPUTE_SHADER)
+        .addStorageBufferWrite(params.feedbackBuffer, canta::PipelineStage::COMPUTE_SHADER)
+
+        .setExecuteFunction([params, visibilityBufferIndex] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto command = graph.getBuffer(params.command);
+            auto globalBuffer = graph.getBuffer(params.globalBuffer);
+            auto meshletInstanceBuffer = graph.getBuffer(params.meshletInstanceBuffer);
+            auto softwareMeshletBuffer = graph.getBuffer(params.softwareMeshletBuffer);
+            auto visibilityBuffer = graph.getBuffer(visibilityBufferIndex);
+
+            cmd.bindPipeline(params.rasterisePipeline);
+            struct Push {
+                u64 globalDataRef;
+                u64 meshletInstanceBuffer;
+                u64 softwareMeshletBuffer;
+                u64 visibilityBuffer;
+                i32 cameraIndex;
+                u32 width;
+                u32 height;
+                i32 padding;
+            };
+            cmd.pushConstants(canta::ShaderStage::COMPUTE, Push {
+                .globalDataRef = globalBuffer->address(),
+                .meshletInstanceBuffer = meshletInstanceBuffer->address(),
+                .softwareMeshletBuffer = softwareMeshletBuffer->address(),
+                .visibilityBuffer = visibilityBuffer->address(),
+                .cameraIndex = params.cameraIndex,
+                .width = params.width,
+                .height = params.height
+            });
+            cmd.dispatchIndirect(command, 0);
+        });
+
+    // fullscreen pass so the depth test merges the software fragments with the hardware ones
+    auto& resolvePass = graph.addPass("resolve", canta::PassType::GRAPHICS, rasterGroup)
+        .addStorageBufferRead(visibilityBufferIndex, canta::PipelineStage::FRAGMENT_SHADER)
+        .addColourWrite(params.visibilityImage)
+        .addDepthWrite(params.depthImage)
+        .setExecuteFunction([params, visibilityBufferIndex] (canta::CommandBuffer& cmd, canta::RenderGraph& graph) {
+            auto visibilityBuffer = graph.getBuffer(visibilityBufferIndex);
+
+            cmd.bindPipeline(params.resolvePipeline);
+            struct Push {
+                u64 visibilityBuffer;
+                u32 width;
+                i32 padding;
+            };
+            cmd.pushConstants(canta::ShaderStage::FRAGMENT, Push {
+                .visibilityBuffer = visibilityBuffer->address(),
+                .width = params.width
+            });
+            cmd.draw(3, 1, 0, 0);
+        });
+    return resolvePass;
+}
@@ -0,0 +1,34 @@
+#ifndef CEN_SOFTWARERASTERPASS_H
+#define CEN_SOFTWARERASTERPASS_H
+
+#include <Canta/RenderGraph.h>
+
+namespace cen::passes {
+
+    struct RasteriseMeshletsParams {
+        canta::BufferIndex command;
+        canta::BufferIndex globalBuffer;
+        canta::BufferIndex vertexBuffer;
+        canta::BufferIndex indexBuffer;
+        canta::BufferIndex primitiveBuffer;
+        canta::BufferIndex meshletBuffer;
+        canta::BufferIndex transformBuffer;
+        canta::BufferIndex cameraBuffer;
+        canta::BufferIndex feedbackBuffer;
+        // the rasterised meshlets are appended after the hardware opaque instances so the material pass finds them
+        canta::BufferIndex meshletInstanceBuffer;
+        canta::BufferIndex softwareMeshletBuffer;
+        canta::ImageIndex visibilityImage;
+        canta::ImageIndex depthImage;
+        i32 cameraIndex;
+        u32 width;
+        u32 height;
+        canta::PipelineHandle rasterisePipeline;
+        canta::PipelineHandle resolvePipeline;
+        std::string_view name;
+    };
+    auto rasteriseMeshlets(canta::RenderGraph& graph, RasteriseMeshletsParams params) -> canta::RenderPass&;
+
+}
+
+#endif //CEN_SOFTWARERASTERPASS_H
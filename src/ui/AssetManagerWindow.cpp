@@ -49,6 +49,7 @@ void cen::ui::AssetManagerWindow::render() {
         if (ImGui::BeginTabBar("Assets")) {
             if (ImGui::BeginTabItem("Pipelines")) {
                 if (ImGui::BeginTable("Pipelines", columnCount)) {
+                    std::unique_lock lock(*pipelineMutex);
                     for (auto& [key, value] : pipelineManager->pipelines()) {
                         renderAssetPipeline(*pipelineManager, key, value);
                         ImGui::TableNextColumn();
@@ -79,6 +80,18 @@ void cen::ui::AssetManagerWindow::render() {
                         ImGui::PushID(model.meshes.size());
                         ImGui::Text("ImageCount: %d", model.images.size());
                         ImGui::Text("MeshCount: %d", model.meshes.size());
+                        if (model.statistics.triangleCount > 0) {
+                            ImGui::Text("Vertices: %d", model.statistics.vertexCount);
+                            ImGui::Text("Triangles: %d", model.statistics.triangleCount);
+                            ImGui::Text("Meshlets: %d", model.statistics.meshletCount);
+                            ImGui::Text("ACMR: %.3f", model.statistics.acmr);
+                            ImGui::Text("ATVR: %.3f", model.statistics.atvr);
+                            ImGui::Text("Overdraw: %.3f", model.statistics.overdraw);
+                            ImGui::Text("Overfetch: %.3f", model.statistics.overfetch);
+                            ImGui::Text("Meshlet Vertex Fill: %.0f%%", model.statistics.vertexFill * 100);
+                            ImGui::Text("Meshlet Primitive Fill: %.0f%%", model.statistics.primitiveFill * 100);
+                            ImGui::Text("Meshlet Radius: %.4f", model.statistics.meshletRadius);
+                        }
                         ImGui::PopID();
                         ImGui::TableNextColumn();
                     }
@@ -86,6 +99,21 @@ void cen::ui::AssetManagerWindow::render() {
                 }
                 ImGui::EndTabItem();
             }
+            if (ImGui::BeginTabItem("Import")) {
+                auto& settings = assetManager->importSettings();
+                ImGui::Checkbox("Weld Vertices", &settings.weldVertices);
+                ImGui::Checkbox("Optimise Vertex Cache", &settings.optimiseVertexCache);
+                ImGui::Checkbox("Optimise Overdraw", &settings.optimiseOverdraw);
+                ImGui::Checkbox("Optimise Vertex Fetch", &settings.optimiseVertexFetch);
+                ImGui::Checkbox("Optimise Meshlets", &settings.optimiseMeshlets);
+                const char* builders[] = { "Greedy", "Spatial" };
+                i32 builder = static_cast<i32>(settings.meshletBuilder);
+                if (ImGui::Combo("Meshlet Builder", &builder, builders, 2))
+                    settings.meshletBuilder = static_cast<AssetManager::MeshletBuilder>(builder);
+                ImGui::Checkbox("Classify Alpha", &settings.classifyAlpha);
+                ImGui::Checkbox("Analyse", &settings.analyse);
+                ImGui::EndTabItem();
+            }
             if (ImGui::BeginTabItem("Materials")) {
                 if (ImGui::BeginTable("Materials", columnCount)) {
                     for (auto& material : assetManager->materials()) {
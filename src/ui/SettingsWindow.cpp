@@ -50,10 +50,18 @@ void cen::ui::SettingsWindow::render() {
         }
 
         if (ImGui::Button("Reload Pipelines")) {
+            std::unique_lock lock(engine->pipelineMutex());
             engine->pipelineManager().reloadAll(true);
         }
 
         auto& renderSettings = renderer->renderSettings();
+        ImGui::Checkbox("Precompute Normal Matrices", &renderSettings.normalMatrices);
+        ImGui::Checkbox("Software Raster", &renderSettings.softwareRaster);
+        if (renderSettings.softwareRaster)
+            ImGui::SliderFloat("Software Raster Threshold", &renderSettings.softwareRasterThreshold, 1, 64);
+        ImGui::Checkbox("Cluster LOD", &renderSettings.clusterLod);
+        if (renderSettings.clusterLod)
+            ImGui::SliderFloat("LOD Error Threshold", &renderSettings.lodErrorThreshold, 0, 16);
         if (ImGui::TreeNode("Bloom Settings")) {
             ImGui::Checkbox("Enable Bloom", &renderSettings.bloom);
             ImGui::SliderInt("Bloom Mips", &renderSettings.bloomMips, 1, 10);
@@ -66,6 +74,23 @@ void cen::ui::SettingsWindow::render() {
             if (ImGui::Combo("Tonemap Operator", &tonemapModeIndex, tonemapModes, 6)) {
                 renderSettings.tonemapModeIndex = tonemapModeIndex;
             }
+            ImGui::Checkbox("Auto Exposure", &renderSettings.autoExposure);
+            ImGui::DragFloat(renderSettings.autoExposure ? "Exposure Compensation" : "Exposure", &renderSettings.exposure, 0.01, 0, 100);
+            if (renderSettings.autoExposure) {
+                ImGui::DragFloat("Min Log Luminance", &renderSettings.minLogLuminance, 0.1);
+                ImGui::DragFloat("Max Log Luminance", &renderSettings.maxLogLuminance, 0.1);
+                ImGui::DragFloat("Adaptation Rate", &renderSettings.exposureAdaptationRate, 0.01, 0, 10);
+                ImGui::DragFloat("Key Value", &renderSettings.exposureKeyValue, 0.01, 0, 1);
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Shadow Settings")) {
+            ImGui::Checkbox("Shadows", &renderSettings.shadows);
+            ImGui::SliderInt("Cascade Count", &renderSettings.shadowCascadeCount, 1, MAX_SHADOW_CASCADES);
+            ImGui::SliderFloat("Split Lambda", &renderSettings.shadowCascadeSplitLambda, 0, 1);
+            ImGui::DragFloat("Shadow Distance", &renderSettings.shadowDistance, 1, 1, 1000);
+            ImGui::DragFloat("Depth Bias", &renderSettings.shadowBias, 0.0001, 0, 0.1, "%.4f");
+            ImGui::DragFloat("Normal Offset", &renderSettings.shadowNormalOffset, 0.1, 0, 10);
             ImGui::TreePop();
         }
         if (ImGui::TreeNode("Debug Settings")) {
@@ -75,7 +100,7 @@ void cen::ui::SettingsWindow::render() {
             ImGui::Checkbox("MaterialId", &renderSettings.debugMaterialId);
             ImGui::Checkbox("Wireframe Solid", &renderSettings.debugWireframe);
             ImGui::SliderInt("DebugFrustum", &renderSettings.debugFrustumIndex, -1, cameraCount - 1);
-            ImGui::DragFloat("Debug Line Width", &renderSettings.debugLineWidth, 0.1);
+            ImGui::SliderFloat("Debug Line Width", &renderSettings.debugLineWidth, 0.5, 8, "%.1f");
             ImGui::ColorEdit3("Debug Colour", &renderSettings.debugColour[0]);
             ImGui::TreePop();
         }
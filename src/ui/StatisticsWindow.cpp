@@ -86,6 +86,22 @@ void cen::ui::StatisticsWindow::render() {
             ImGui::TreePop();
         }
 
+        if (engine->geometryStreamer().enabled() && ImGui::TreeNode("Geometry Streaming")) {
+            auto& streamer = engine->geometryStreamer();
+            ImGui::Text("Resident Pages: %d / %d", streamer.residentPages(), streamer.pageCount());
+            ImGui::Text("Page Slots: %d", streamer.slotCount());
+            ImGui::TreePop();
+        }
+
+        if (ImGui::TreeNode("Shader Cache")) {
+            // a warm start should load every shader from the cache
+            auto& shaderCache = engine->shaderCache();
+            ImGui::Text("Startup Pipelines: %.2fms", renderer->pipelineCreateMilliseconds());
+            ImGui::Text("Shaders From Cache: %u", shaderCache.hits());
+            ImGui::Text("Shaders Compiled: %u", shaderCache.misses());
+            ImGui::TreePop();
+        }
+
         if (ImGui::TreeNode("Resource Stats")) {
             auto resourceStats = engine->device()->resourceStats();
             ImGui::Text("Shader Count %d", resourceStats.shaderCount);